@@ -0,0 +1,138 @@
+// SPDX-FileCopyrightText: 2025 Marius Dege <marius.dege@basyskom.com>
+// SPDX-FileCopyrightText: 2024 Marius Dege <marius.dege@basyskom.com>
+// SPDX-FileCopyrightText: 2024 basysKom GmbH
+
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "allocationcounter.h"
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <new>
+
+#if defined(Q_OS_UNIX)
+#include <sys/resource.h>
+#endif
+
+namespace {
+std::atomic<quint64> s_allocations = 0;
+std::atomic<quint64> s_bytes = 0;
+
+void count(size_t size)
+{
+    s_allocations.fetch_add(1, std::memory_order_relaxed);
+    s_bytes.fetch_add(size, std::memory_order_relaxed);
+}
+} // namespace
+
+#if defined(__GLIBC__)
+// The definitions in the executable take precedence over the ones in libc for all libraries,
+// operator new of libstdc++ ends up here as well.
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* pointer, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+
+void* malloc(size_t size)
+{
+    count(size);
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size)
+{
+    ::count(count * size);
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* pointer, size_t size)
+{
+    count(size);
+    return __libc_realloc(pointer, size);
+}
+
+void* memalign(size_t alignment, size_t size)
+{
+    count(size);
+    return __libc_memalign(alignment, size);
+}
+
+void* aligned_alloc(size_t alignment, size_t size)
+{
+    count(size);
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void** pointer, size_t alignment, size_t size)
+{
+    count(size);
+    *pointer = __libc_memalign(alignment, size);
+    return *pointer ? 0 : ENOMEM;
+}
+}
+#else
+void* operator new(size_t size)
+{
+    count(size);
+    if (void* pointer = std::malloc(size ? size : 1))
+        return pointer;
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer, size_t) noexcept
+{
+    std::free(pointer);
+}
+#endif
+
+AllocationCounter::Stats AllocationCounter::stats()
+{
+    return {s_allocations.load(std::memory_order_relaxed), s_bytes.load(std::memory_order_relaxed)};
+}
+
+bool AllocationCounter::coversMalloc()
+{
+#if defined(__GLIBC__)
+    return true;
+#else
+    return false;
+#endif
+}
+
+qint64 AllocationCounter::peakRssKiB()
+{
+#if defined(Q_OS_UNIX)
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return -1;
+#if defined(Q_OS_DARWIN)
+    // reported in bytes on macOS
+    return usage.ru_maxrss / 1024;
+#else
+    return usage.ru_maxrss;
+#endif
+#else
+    return -1;
+#endif
+}
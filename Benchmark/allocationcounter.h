@@ -0,0 +1,30 @@
+// SPDX-FileCopyrightText: 2025 Marius Dege <marius.dege@basyskom.com>
+// SPDX-FileCopyrightText: 2024 Marius Dege <marius.dege@basyskom.com>
+// SPDX-FileCopyrightText: 2024 basysKom GmbH
+
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#ifndef ALLOCATIONCOUNTER_H
+#define ALLOCATIONCOUNTER_H
+
+#include <QtGlobal>
+
+// Process wide heap statistics of the benchmark. With glibc the malloc family is wrapped, which
+// also covers the Qt containers. On other platforms only operator new is counted.
+class AllocationCounter
+{
+public:
+    struct Stats
+    {
+        quint64 allocations = 0;
+        quint64 bytes = 0;
+    };
+
+    static Stats stats();
+    static bool coversMalloc();
+
+    // Peak resident set size of the process in KiB, -1 if the platform does not report it.
+    static qint64 peakRssKiB();
+};
+
+#endif // ALLOCATIONCOUNTER_H
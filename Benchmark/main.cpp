@@ -0,0 +1,589 @@
+// SPDX-FileCopyrightText: 2025 Marius Dege <marius.dege@basyskom.com>
+// SPDX-FileCopyrightText: 2024 Marius Dege <marius.dege@basyskom.com>
+// SPDX-FileCopyrightText: 2024 basysKom GmbH
+
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+// Headless benchmark of the NodeSet parser and the resolve passes. Runs over the UA core
+// nodeset and over generated synthetic nodesets and prints the results as JSON.
+
+#include "Util/AtomTable.h"
+#include "Util/DecompressingDevice.h"
+#include "Util/Utils.h"
+#include "allocationcounter.h"
+#include "nodegraph.h"
+#include "nodesetresolver.h"
+#include "nodesetsnapshot.h"
+#include "syntheticnodeset.h"
+#include "treemodel.h"
+#include "uanodesetparser.h"
+
+#include <QBuffer>
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QXmlStreamReader>
+
+#include <algorithm>
+#include <iterator>
+
+namespace {
+struct Measurement
+{
+    qint64 nanoseconds = 0;
+    AllocationCounter::Stats allocations;
+};
+
+struct Iteration
+{
+    Measurement parse;
+    Measurement resolve;
+    // one more datatype pass over the resolved nodesets, through the DataType index and through
+    // the former lookup of every variable's alias in all nodesets
+    Measurement dataTypes;
+    Measurement dataTypesPerVariable;
+    // reads the internal accessors of every resolved node and of the items of the type model
+    Measurement access;
+    // TreeModel::data for the string roles of every item, and the strings of the code generation
+    Measurement modelData;
+    Measurement generation;
+    // strings converted from the stored UTF-8, the most the two passes above may allocate
+    qint64 modelConversions = 0;
+    qint64 generationConversions = 0;
+    qsizetype nodeCount = 0;
+};
+
+// TreeModel::data roles that convert the stored UTF-8 into a QString
+constexpr int ConvertedRoles[] = {
+    Qt::DisplayRole,
+    TreeModel::NodeIdRole,
+    TreeModel::BrowseNameRole,
+    TreeModel::DisplayNameRole,
+    TreeModel::DescriptionRole,
+    TreeModel::ParentNodeIdRole,
+    TreeModel::NodeIdVariableNameRole,
+};
+// roles that share a QString the AtomTable or the node type already holds
+constexpr int SharedRoles[] = {TreeModel::NamespaceStringRole, TreeModel::TypeNameRole};
+
+QtMessageHandler s_defaultMessageHandler = nullptr;
+
+// The parser reports every unresolved reference, which would drown the results.
+void quietMessageHandler(QtMsgType type, const QMessageLogContext& context, const QString& msg)
+{
+    if (s_defaultMessageHandler && type != QtDebugMsg && type != QtInfoMsg
+        && type != QtWarningMsg)
+        s_defaultMessageHandler(type, context, msg);
+}
+
+template<typename Function>
+Measurement measure(Function function)
+{
+    const AllocationCounter::Stats before = AllocationCounter::stats();
+    QElapsedTimer timer;
+    timer.start();
+    function();
+    Measurement result;
+    result.nanoseconds = timer.nsecsElapsed();
+    const AllocationCounter::Stats after = AllocationCounter::stats();
+    result.allocations = {after.allocations - before.allocations, after.bytes - before.bytes};
+    return result;
+}
+
+// The last file is the selected model, like in the app
+QMap<QString, std::shared_ptr<UANodeSet>> parseFiles(
+    const QStringList& files, bool fastTokenizer, QString* selectedModelUri = nullptr)
+{
+    QMap<QString, std::shared_ptr<UANodeSet>> nodeSets;
+    for (const QString& file : files) {
+        std::shared_ptr<UANodeSet> nodeSet = std::make_shared<UANodeSet>();
+        UaNodeSetParser parser;
+        parser.setUseFastTokenizer(fastTokenizer);
+        if (!parser.parse(file, nodeSet.get()))
+            qCritical() << "Could not parse" << file;
+        nodeSets.insert(nodeSet->getNameSpaceUri(), nodeSet);
+        if (selectedModelUri)
+            *selectedModelUri = nodeSet->getNameSpaceUri();
+    }
+    return nodeSets;
+}
+
+// Sums up what the accessors return, so the reads cannot be optimised away. These are the
+// accessors of the resolver, the graph and the models, they return views, atoms and references
+// and none of this should allocate.
+qsizetype readAccessors(const QList<std::shared_ptr<UANode>>& nodes)
+{
+    qsizetype sum = 0;
+    for (const std::shared_ptr<UANode>& node : nodes) {
+        sum += node->nodeIdUtf8().size() + node->browseNameUtf8().size()
+               + node->displayNameUtf8().size() + node->descriptionUtf8().size()
+               + node->nodeVariableNameUtf8().size() + node->namespaceAtom()
+               + node->typeName().size();
+        for (const std::shared_ptr<Reference>& reference : node->references())
+            sum += reference->isForward() + reference->targetNodeIdUtf8().size()
+                   + reference->namespaceAtom();
+        if (const UAVariable* variable = dynamic_cast<const UAVariable*>(node.get())) {
+            const UADataType& dataType = variable->dataType();
+            sum += dataType.definitionNameAtom() + dataType.definitionFields().size()
+                   + dataType.references().size() + variable->arguments().size();
+        } else if (const UADataType* dataType = dynamic_cast<const UADataType*>(node.get())) {
+            sum += dataType->definitionFields().size();
+        }
+    }
+    return sum;
+}
+
+qsizetype readItems(const QList<TreeItem*>& items)
+{
+    qsizetype sum = 0;
+    for (const TreeItem* item : items) {
+        sum += item->nodeIdUtf8().size() + item->browseNameUtf8().size()
+               + item->displayNameUtf8().size() + item->descriptionUtf8().size()
+               + item->parentNodeIdUtf8().size() + item->nodeVariableNameUtf8().size()
+               + item->namespaceAtom() + item->typeName().size() + item->isOptional()
+               + item->references().size();
+    }
+    return sum;
+}
+
+void collectItems(const TreeModel& model, const QModelIndex& parent, QList<TreeItem*>& items)
+{
+    for (int row = 0; row < model.rowCount(parent); ++row) {
+        const QModelIndex index = model.index(row, 0, parent);
+        items.append(static_cast<TreeItem*>(index.internalPointer()));
+        collectItems(model, index, items);
+    }
+}
+
+// What QML reads for every row. Each converted role may allocate its QString once.
+qsizetype readModelData(const TreeModel& model, const QModelIndex& parent, qint64& conversions)
+{
+    qsizetype sum = 0;
+    for (int row = 0; row < model.rowCount(parent); ++row) {
+        const QModelIndex index = model.index(row, 0, parent);
+        for (const int role : ConvertedRoles)
+            sum += model.data(index, role).toString().size();
+        for (const int role : SharedRoles)
+            sum += model.data(index, role).toString().size();
+        conversions += std::size(ConvertedRoles);
+        sum += readModelData(model, index, conversions);
+    }
+    return sum;
+}
+
+// The node strings DeviceDriverCore::createNodeMap puts into the mustache data, each one copied
+// straight from the stored UTF-8
+qsizetype readGenerationStrings(const QList<TreeItem*>& items, qint64& conversions)
+{
+    qsizetype sum = 0;
+    for (const TreeItem* item : items) {
+        sum += Utils::toStdString(item->nodeIdUtf8()).size()
+               + Utils::toStdString(item->displayNameUtf8()).size()
+               + Utils::toStdString(item->descriptionUtf8()).size();
+        conversions += 3;
+    }
+    return sum;
+}
+
+// The datatype pass as it was before NodeSetResolver::resolveDataTypes indexed the DataTypes:
+// every variable resolves its alias and then searches each nodeset by the string NodeId.
+void resolveDataTypesPerVariable(const QMap<QString, std::shared_ptr<UANodeSet>>& nodeSets)
+{
+    for (const std::shared_ptr<UANodeSet>& nodeSet : nodeSets) {
+        for (const std::shared_ptr<UANode>& node : nodeSet->loadedNodes()) {
+            if (node->typeName() != XmlTags::UAVariable)
+                continue;
+            std::shared_ptr<UAVariable> variable = std::dynamic_pointer_cast<UAVariable>(node);
+            const QString dataTypeNode = nodeSet->getNodeIdByAlias(
+                variable->dataType().definitionNameAtom());
+            if (dataTypeNode.isEmpty())
+                continue;
+            for (const std::shared_ptr<UANodeSet>& ns : nodeSets) {
+                const std::shared_ptr<UANode> found = ns->findNodeById(dataTypeNode);
+                if (found && found->typeName() == XmlTags::UADataType) {
+                    if (auto dataType = std::dynamic_pointer_cast<UADataType>(found))
+                        variable->setDataType(*dataType);
+                }
+            }
+        }
+    }
+}
+
+Iteration runIteration(const QStringList& files)
+{
+    Iteration iteration;
+    QMap<QString, std::shared_ptr<UANodeSet>> nodeSets;
+
+    QString selectedModelUri;
+    iteration.parse = measure([&files, &nodeSets, &selectedModelUri]() {
+        nodeSets = parseFiles(files, true, &selectedModelUri);
+    });
+
+    NodeSetResolver resolver(nodeSets);
+    iteration.resolve = measure([&resolver, &iteration]() {
+        iteration.nodeCount = resolver.resolve();
+    });
+    iteration.dataTypes = measure([&resolver]() { resolver.resolveDataTypes(); });
+    iteration.dataTypesPerVariable = measure(
+        [&nodeSets]() { resolveDataTypesPerVariable(nodeSets); });
+
+    QList<std::shared_ptr<UANode>> nodes;
+    for (const std::shared_ptr<UANodeSet>& nodeSet : std::as_const(nodeSets))
+        nodes.append(nodeSet->loadedNodes());
+
+    // the type list of the selected model, as DeviceDriverCore::applyNodeSets builds it
+    TreeModel model;
+    model.setNodeGraph(std::make_shared<NodeGraph>(nodeSets));
+    if (const std::shared_ptr<UANodeSet> selected = nodeSets.value(selectedModelUri))
+        model.setupModelData(selected);
+    QList<TreeItem*> items;
+    collectItems(model, QModelIndex(), items);
+
+    qsizetype sum = 0;
+    iteration.access = measure([&nodes, &items, &sum]() {
+        sum = readAccessors(nodes) + readItems(items);
+    });
+    iteration.modelData = measure([&model, &iteration, &sum]() {
+        sum += readModelData(model, QModelIndex(), iteration.modelConversions);
+    });
+    iteration.generation = measure([&items, &iteration, &sum]() {
+        sum += readGenerationStrings(items, iteration.generationConversions);
+    });
+    Q_UNUSED(sum);
+    return iteration;
+}
+
+// Parses and resolves the files with the given tokenizer and serializes the result.
+QByteArray resolvedSnapshot(const QStringList& files, bool fastTokenizer)
+{
+    const QMap<QString, std::shared_ptr<UANodeSet>> nodeSets = parseFiles(files, fastTokenizer);
+    NodeSetResolver(nodeSets).resolve();
+
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+    if (!NodeSetSnapshot::write(&buffer, nodeSets))
+        qCritical() << "Could not serialize the parsed NodeSets";
+    return buffer.data();
+}
+
+QJsonObject toJson(const Measurement& measurement, qsizetype nodeCount)
+{
+    const double seconds = measurement.nanoseconds / 1e9;
+    return QJsonObject{
+        {QStringLiteral("wall_ms"), measurement.nanoseconds / 1e6},
+        {QStringLiteral("nodes_per_second"), seconds > 0 ? nodeCount / seconds : 0.0},
+        {QStringLiteral("allocations"), double(measurement.allocations.allocations)},
+        {QStringLiteral("allocated_bytes"), double(measurement.allocations.bytes)},
+    };
+}
+
+// The element names the parser compared against before XmlTags::token(), in the order of its
+// if-else chains. Every comparison converted the name into a QString first.
+const QString* const LegacyElementNames[] = {
+    &XmlTags::UANodeSet,
+    &XmlTags::Models,
+    &XmlTags::UAObject,
+    &XmlTags::UADataType,
+    &XmlTags::UAVariable,
+    &XmlTags::UAMethod,
+    &XmlTags::UAVariableType,
+    &XmlTags::UAObjectType,
+    &XmlTags::UAReferenceType,
+    &XmlTags::Aliases,
+    &XmlTags::References,
+    &XmlTags::Reference,
+    &XmlTags::Definition,
+    &XmlTags::Field,
+    &XmlTags::Value,
+};
+
+enum class Dispatch { None, Legacy, Token };
+
+// Reads every start and end element of the file and dispatches on its name. Returns the element
+// count, the sum only keeps the dispatch from being optimised away.
+qint64 dispatchElements(const QString& file, Dispatch dispatch, qsizetype& sum)
+{
+    DecompressingDevice device(file);
+    if (!device.open(QIODevice::ReadOnly))
+        return 0;
+    QXmlStreamReader xml(&device);
+    qint64 elements = 0;
+    while (!xml.atEnd()) {
+        xml.readNext();
+        if (!xml.isStartElement() && !xml.isEndElement())
+            continue;
+        ++elements;
+        switch (dispatch) {
+        case Dispatch::None:
+            sum += xml.name().size();
+            break;
+        case Dispatch::Legacy:
+            for (const QString* name : LegacyElementNames) {
+                if (xml.name().toString() == *name) {
+                    sum += name->size();
+                    break;
+                }
+            }
+            break;
+        case Dispatch::Token:
+            sum += int(XmlTags::token(xml.name()));
+            break;
+        }
+    }
+    return elements;
+}
+
+// Per element cost of the name dispatch before and after XmlTags::token(). Reading the XML is
+// measured on its own and subtracted, the fastest of the iterations is reported.
+QJsonObject measureDispatch(const QString& file, int iterations)
+{
+    qint64 elements = 0;
+    qsizetype sum = 0;
+    const auto best = [&](Dispatch dispatch) {
+        Measurement fastest;
+        for (int i = 0; i < iterations; ++i) {
+            const Measurement measurement = measure(
+                [&]() { elements = dispatchElements(file, dispatch, sum); });
+            if (i == 0 || measurement.nanoseconds < fastest.nanoseconds)
+                fastest = measurement;
+        }
+        return fastest;
+    };
+    const Measurement read = best(Dispatch::None);
+    const Measurement legacy = best(Dispatch::Legacy);
+    const Measurement token = best(Dispatch::Token);
+    Q_UNUSED(sum);
+
+    const auto perElement = [&read, &elements](const Measurement& measurement) {
+        const double count = qMax<qint64>(1, elements);
+        return QJsonObject{
+            {QStringLiteral("ns_per_element"),
+             (measurement.nanoseconds - read.nanoseconds) / count},
+            {QStringLiteral("allocations_per_element"),
+             (measurement.allocations.allocations - read.allocations.allocations) / count},
+            {QStringLiteral("wall_ms"), measurement.nanoseconds / 1e6},
+        };
+    };
+    return QJsonObject{
+        {QStringLiteral("file"), QFileInfo(file).fileName()},
+        {QStringLiteral("elements"), double(elements)},
+        {QStringLiteral("read_ms"), read.nanoseconds / 1e6},
+        {QStringLiteral("to_string_compare"), perElement(legacy)},
+        {QStringLiteral("token"), perElement(token)},
+    };
+}
+
+// Reports the fastest iteration, the others only differ by noise and warm caches.
+QJsonObject runCase(const QString& name,
+                    const QStringList& files,
+                    int iterations,
+                    bool differential)
+{
+    QList<Iteration> results;
+    for (int i = 0; i < iterations; ++i)
+        results.append(runIteration(files));
+
+    const auto total = [](const Iteration& iteration) {
+        return iteration.parse.nanoseconds + iteration.resolve.nanoseconds;
+    };
+    const Iteration& best = *std::min_element(
+        results.cbegin(), results.cend(), [&total](const Iteration& a, const Iteration& b) {
+            return total(a) < total(b);
+        });
+
+    Measurement overall;
+    overall.nanoseconds = total(best);
+    overall.allocations.allocations = best.parse.allocations.allocations
+                                      + best.resolve.allocations.allocations;
+    overall.allocations.bytes = best.parse.allocations.bytes + best.resolve.allocations.bytes;
+
+    QJsonArray fileArray;
+    for (const QString& file : files)
+        fileArray.append(QFileInfo(file).fileName());
+
+    QJsonObject result = toJson(overall, best.nodeCount);
+    result.insert(QStringLiteral("name"), name);
+    result.insert(QStringLiteral("files"), fileArray);
+    result.insert(QStringLiteral("nodes"), double(best.nodeCount));
+    result.insert(QStringLiteral("iterations"), iterations);
+    result.insert(QStringLiteral("parse"), toJson(best.parse, best.nodeCount));
+    result.insert(QStringLiteral("resolve"), toJson(best.resolve, best.nodeCount));
+    result.insert(QStringLiteral("resolve_data_types"), toJson(best.dataTypes, best.nodeCount));
+    result.insert(QStringLiteral("resolve_data_types_per_variable"),
+                  toJson(best.dataTypesPerVariable, best.nodeCount));
+    result.insert(QStringLiteral("access"), toJson(best.access, best.nodeCount));
+    QJsonObject modelData = toJson(best.modelData, best.nodeCount);
+    modelData.insert(QStringLiteral("conversions"), double(best.modelConversions));
+    result.insert(QStringLiteral("model_data"), modelData);
+    QJsonObject generation = toJson(best.generation, best.nodeCount);
+    generation.insert(QStringLiteral("conversions"), double(best.generationConversions));
+    result.insert(QStringLiteral("generation_strings"), generation);
+    if (best.access.allocations.allocations > 0)
+        qCritical() << "Reading the node accessors allocated memory for" << name;
+    if (best.modelData.allocations.allocations > best.modelConversions
+        || best.generation.allocations.allocations > best.generationConversions)
+        qCritical() << "Model data or code generation strings were copied more than once for"
+                    << name;
+    // the peak is process wide, cases run from small to large to keep it meaningful
+    result.insert(QStringLiteral("peak_rss_kib"), double(AllocationCounter::peakRssKiB()));
+
+    if (differential) {
+        const bool identical = resolvedSnapshot(files, true) == resolvedSnapshot(files, false);
+        result.insert(QStringLiteral("differential"),
+                      identical ? QStringLiteral("identical") : QStringLiteral("mismatch"));
+        if (!identical)
+            qCritical() << "Tokenizer and QXmlStreamReader results differ for" << name;
+    }
+    return result;
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName(QStringLiteral("open62541devicedriver_bench"));
+
+    QCommandLineParser commandLine;
+    commandLine.setApplicationDescription(
+        QStringLiteral("Benchmarks the NodeSet parser and the resolve passes."));
+    commandLine.addHelpOption();
+    const QCommandLineOption nodeSetDirOption(
+        QStringLiteral("nodeset-dir"),
+        QStringLiteral("UA-Nodeset checkout, the core nodeset is read from Schema/."),
+        QStringLiteral("dir"),
+        QDir(QCoreApplication::applicationDirPath()).filePath(QStringLiteral("../../UA-Nodeset/")));
+    const QCommandLineOption stackOption(
+        QStringLiteral("stack"),
+        QStringLiteral("Comma separated NodeSet files in the nodeset dir, parsed together."),
+        QStringLiteral("files"),
+        QStringLiteral("Schema/Opc.Ua.NodeSet2.xml,"
+                       "DI/Opc.Ua.Di.NodeSet2.xml,"
+                       "Machinery/Opc.Ua.Machinery.NodeSet2.xml,"
+                       "AutoID/Opc.Ua.AutoID.NodeSet2.xml"));
+    const QCommandLineOption sizesOption(
+        QStringLiteral("sizes"),
+        QStringLiteral("Comma separated node counts of the synthetic nodesets."),
+        QStringLiteral("counts"),
+        QStringLiteral("10000,100000,1000000"));
+    const QCommandLineOption iterationsOption(
+        QStringLiteral("iterations"),
+        QStringLiteral("Runs per case, the fastest one is reported."),
+        QStringLiteral("count"),
+        QStringLiteral("3"));
+    const QCommandLineOption outputOption(
+        QStringLiteral("output"),
+        QStringLiteral("Write the JSON report to a file instead of stdout."),
+        QStringLiteral("file"));
+    const QCommandLineOption verboseOption(
+        QStringLiteral("verbose"), QStringLiteral("Keep the log output of parser and resolver."));
+    const QCommandLineOption differentialOption(
+        QStringLiteral("differential"),
+        QStringLiteral("Compare the results of the NodeSet tokenizer with QXmlStreamReader."));
+    commandLine.addOptions({nodeSetDirOption,
+                            stackOption,
+                            sizesOption,
+                            iterationsOption,
+                            outputOption,
+                            verboseOption,
+                            differentialOption});
+    commandLine.process(app);
+
+    if (!commandLine.isSet(verboseOption))
+        s_defaultMessageHandler = qInstallMessageHandler(quietMessageHandler);
+
+    const int iterations = qMax(1, commandLine.value(iterationsOption).toInt());
+    const bool differential = commandLine.isSet(differentialOption);
+    // Utils is created lazily and used while parsing
+    Utils::instance();
+
+    QJsonArray cases;
+    QJsonObject dispatch;
+
+    const QString coreNodeSet = QDir(commandLine.value(nodeSetDirOption))
+                                    .filePath(QStringLiteral("Schema/Opc.Ua.NodeSet2.xml"));
+    if (QFileInfo::exists(coreNodeSet)) {
+        cases.append(runCase(QStringLiteral("core"), {coreNodeSet}, iterations, differential));
+        dispatch = measureDispatch(coreNodeSet, iterations);
+    } else {
+        qCritical() << "Core NodeSet not found, skipping:" << coreNodeSet;
+    }
+
+    QStringList stack;
+    for (const QString& file : commandLine.value(stackOption).split(QLatin1Char(','))) {
+        stack.append(QDir(commandLine.value(nodeSetDirOption)).filePath(file.trimmed()));
+    }
+    const auto missing = std::find_if(stack.cbegin(), stack.cend(), [](const QString& file) {
+        return !QFileInfo::exists(file);
+    });
+    if (missing == stack.cend()) {
+        cases.append(runCase(QStringLiteral("stack"), stack, iterations, differential));
+    } else {
+        qCritical() << "Stack NodeSet not found, skipping:" << *missing;
+    }
+
+    QTemporaryDir workDir;
+    if (!workDir.isValid()) {
+        qCritical() << "Could not create a directory for the synthetic NodeSets";
+        return 1;
+    }
+    QList<int> sizes;
+    for (const QString& size : commandLine.value(sizesOption).split(QLatin1Char(','))) {
+        if (const int nodeCount = size.trimmed().toInt(); nodeCount > 0)
+            sizes.append(nodeCount);
+    }
+    std::sort(sizes.begin(), sizes.end());
+    for (const int nodeCount : std::as_const(sizes)) {
+        const QString file = workDir.filePath(
+            QStringLiteral("Synthetic%1.NodeSet2.xml").arg(nodeCount));
+        if (!SyntheticNodeSet::write(file, nodeCount))
+            return 1;
+        cases.append(runCase(
+            QStringLiteral("synthetic_%1").arg(nodeCount), {file}, iterations, differential));
+        QFile::remove(file);
+    }
+
+    const QJsonObject report{
+        {QStringLiteral("benchmark"), QCoreApplication::applicationName()},
+        {QStringLiteral("qt_version"), QString::fromLatin1(qVersion())},
+        {QStringLiteral("allocations_include_malloc"), AllocationCounter::coversMalloc()},
+        {QStringLiteral("interned_strings"), double(AtomTable::instance()->size())},
+        {QStringLiteral("dispatch"), dispatch},
+        {QStringLiteral("cases"), cases},
+    };
+    const QByteArray json = QJsonDocument(report).toJson();
+    const bool mismatch = std::any_of(cases.cbegin(), cases.cend(), [](const QJsonValue& result) {
+        return result[QStringLiteral("differential")] == QStringLiteral("mismatch");
+    });
+    // the internal accessors don't allocate, the boundary converts every string at most once
+    const auto copies = [](const QJsonValue& pass) {
+        return pass[QStringLiteral("allocations")].toDouble()
+               > pass[QStringLiteral("conversions")].toDouble();
+    };
+    const bool accessAllocates = std::any_of(
+        cases.cbegin(), cases.cend(), [&copies](const QJsonValue& result) {
+            return result[QStringLiteral("access")][QStringLiteral("allocations")].toDouble() > 0
+                   || copies(result[QStringLiteral("model_data")])
+                   || copies(result[QStringLiteral("generation_strings")]);
+        });
+
+    if (commandLine.isSet(outputOption)) {
+        QFile file(commandLine.value(outputOption));
+        if (!file.open(QIODevice::WriteOnly) || file.write(json) != json.size()) {
+            qCritical() << "Could not write" << file.fileName() << file.errorString();
+            return 1;
+        }
+    } else {
+        QTextStream(stdout) << json;
+    }
+    if (mismatch)
+        return 2;
+    return accessAllocates ? 3 : 0;
+}
@@ -0,0 +1,194 @@
+// SPDX-FileCopyrightText: 2025 Marius Dege <marius.dege@basyskom.com>
+// SPDX-FileCopyrightText: 2024 Marius Dege <marius.dege@basyskom.com>
+// SPDX-FileCopyrightText: 2024 basysKom GmbH
+
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "syntheticnodeset.h"
+#include <QDebug>
+#include <QSaveFile>
+
+namespace {
+constexpr int GroupSize = 20;
+constexpr int BaseObjectTypeId = 1;
+constexpr int BaseDataTypeId = 2;
+
+// Layout of a group, as offsets from the first NodeId of the group
+enum Offset {
+    ObjectTypeOffset = 0,
+    DataTypeOffset = 1,
+    VariableTypeOffset = 2,
+    FirstObjectOffset = 3,
+    ObjectCount = 6,
+    FirstVariableOffset = FirstObjectOffset + ObjectCount,
+    VariableCount = 8,
+    MethodOffset = FirstVariableOffset + VariableCount,
+    InputArgumentsOffset = MethodOffset + 1,
+    OutputArgumentsOffset = MethodOffset + 2,
+};
+static_assert(OutputArgumentsOffset == GroupSize - 1);
+
+QByteArray nodeId(int id)
+{
+    return "ns=1;i=" + QByteArray::number(id);
+}
+
+QByteArray reference(const char* referenceType, int target, bool isForward = true)
+{
+    return QByteArray("      <Reference ReferenceType=\"") + referenceType + '"'
+           + (isForward ? "" : " IsForward=\"false\"") + '>' + nodeId(target) + "</Reference>\n";
+}
+
+QByteArray startNode(const char* element, int id, const QByteArray& browseName, int parentId = 0)
+{
+    QByteArray result = QByteArray("  <") + element + " NodeId=\"" + nodeId(id)
+                        + "\" BrowseName=\"1:" + browseName + '"';
+    if (parentId > 0)
+        result += " ParentNodeId=\"" + nodeId(parentId) + '"';
+    return result;
+}
+
+QByteArray displayName(const QByteArray& name)
+{
+    return "    <DisplayName>" + name + "</DisplayName>\n";
+}
+
+void writeGroup(QByteArray& out, int group)
+{
+    const int base = group * GroupSize + 1;
+    const QByteArray suffix = QByteArray::number(group);
+    const int objectTypeId = base + ObjectTypeOffset;
+
+    // ObjectType, derived from the first ObjectType and owning the objects of the group
+    const QByteArray typeName = "SyntheticObjectType" + suffix;
+    out += startNode("UAObjectType", objectTypeId, typeName) + ">\n" + displayName(typeName)
+           + "    <References>\n";
+    if (objectTypeId != BaseObjectTypeId)
+        out += reference("HasSubtype", BaseObjectTypeId, false);
+    for (int i = 0; i < ObjectCount; ++i)
+        out += reference("HasComponent", base + FirstObjectOffset + i);
+    out += "    </References>\n  </UAObjectType>\n";
+
+    // DataType with a structure definition, derived from the first DataType
+    const int dataTypeId = base + DataTypeOffset;
+    const QByteArray dataTypeName = "SyntheticDataType" + suffix;
+    out += startNode("UADataType", dataTypeId, dataTypeName) + ">\n" + displayName(dataTypeName);
+    if (dataTypeId != BaseDataTypeId)
+        out += "    <References>\n" + reference("HasSubtype", BaseDataTypeId, false)
+               + "    </References>\n";
+    out += "    <Definition Name=\"1:" + dataTypeName + "\">\n"
+           "      <Field Name=\"Count\" DataType=\"i=6\"/>\n"
+           "      <Field Name=\"Value\" DataType=\"i=11\"/>\n"
+           "      <Field Name=\"Label\" DataType=\"i=12\"/>\n"
+           "    </Definition>\n  </UADataType>\n";
+
+    const QByteArray variableTypeName = "SyntheticVariableType" + suffix;
+    out += startNode("UAVariableType", base + VariableTypeOffset, variableTypeName)
+           + " DataType=\"" + dataTypeName + "\">\n" + displayName(variableTypeName)
+           + "  </UAVariableType>\n";
+
+    for (int i = 0; i < ObjectCount; ++i) {
+        const int objectId = base + FirstObjectOffset + i;
+        const QByteArray objectName = "Object" + suffix + '_' + QByteArray::number(i);
+        out += startNode("UAObject", objectId, objectName, objectTypeId) + ">\n"
+               + displayName(objectName) + "    <References>\n"
+               + reference("HasComponent", objectTypeId, false);
+        // the variables are distributed over the objects
+        for (int v = i; v < VariableCount; v += ObjectCount)
+            out += reference("HasComponent", base + FirstVariableOffset + v);
+        if (i == 0)
+            out += reference("HasComponent", base + MethodOffset);
+        out += "    </References>\n  </UAObject>\n";
+    }
+
+    for (int v = 0; v < VariableCount; ++v) {
+        const int parentId = base + FirstObjectOffset + v % ObjectCount;
+        const QByteArray variableName = "Variable" + suffix + '_' + QByteArray::number(v);
+        out += startNode("UAVariable", base + FirstVariableOffset + v, variableName, parentId)
+               + " DataType=\"" + dataTypeName + "\">\n" + displayName(variableName)
+               + "    <References>\n" + reference("HasComponent", parentId, false)
+               + "    </References>\n  </UAVariable>\n";
+    }
+
+    const int methodId = base + MethodOffset;
+    const QByteArray methodName = "Method" + suffix;
+    out += startNode("UAMethod", methodId, methodName, base + FirstObjectOffset) + ">\n"
+           + displayName(methodName) + "    <References>\n"
+           + reference("HasComponent", base + FirstObjectOffset, false)
+           + reference("HasProperty", base + InputArgumentsOffset)
+           + reference("HasProperty", base + OutputArgumentsOffset)
+           + "    </References>\n  </UAMethod>\n";
+
+    for (const auto& [offset, name] : {std::pair{InputArgumentsOffset, "InputArguments"},
+                                       std::pair{OutputArgumentsOffset, "OutputArguments"}}) {
+        out += startNode("UAVariable", base + offset, name, methodId)
+               + " DataType=\"Argument\" ValueRank=\"1\" ArrayDimensions=\"1\">\n"
+               + displayName(name) + "    <References>\n"
+               + reference("HasProperty", methodId, false) + "    </References>\n"
+               + "    <Value>\n      <ListOfExtensionObject "
+                 "xmlns=\"http://opcfoundation.org/UA/2008/02/Types.xsd\">\n"
+                 "        <ExtensionObject>\n"
+                 "          <TypeId><Identifier>i=297</Identifier></TypeId>\n"
+                 "          <Body><Argument><Name>Value</Name>"
+                 "<DataType><Identifier>ns=1;i="
+               + QByteArray::number(base + DataTypeOffset)
+               + "</Identifier></DataType><ValueRank>-1</ValueRank>"
+                 "<Description><Text>Synthetic argument</Text></Description>"
+                 "</Argument></Body>\n"
+                 "        </ExtensionObject>\n      </ListOfExtensionObject>\n"
+                 "    </Value>\n  </UAVariable>\n";
+    }
+}
+} // namespace
+
+QString SyntheticNodeSet::modelUri(int nodeCount)
+{
+    return QStringLiteral("http://basyskom.com/Synthetic/%1/").arg(nodeCount);
+}
+
+bool SyntheticNodeSet::write(const QString& filePath, int nodeCount)
+{
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Could not write synthetic NodeSet" << filePath << file.errorString();
+        return false;
+    }
+
+    const int groupCount = qMax(1, nodeCount / GroupSize);
+    const QByteArray uri = modelUri(nodeCount).toUtf8();
+
+    QByteArray out;
+    out.reserve(1024 * 1024);
+    out += "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+           "<UANodeSet xmlns:xsi=\"http://www.w3.org/2001/XMLSchema-instance\" "
+           "xmlns=\"http://opcfoundation.org/UA/2011/03/UANodeSet.xsd\">\n"
+           "  <NamespaceUris>\n    <Uri>"
+           + uri + "</Uri>\n  </NamespaceUris>\n  <Models>\n    <Model ModelUri=\"" + uri
+           + "\" Version=\"1.00.0\" PublicationDate=\"2025-01-01T00:00:00Z\"/>\n  </Models>\n"
+             "  <Aliases>\n"
+             "    <Alias Alias=\"HasComponent\">i=47</Alias>\n"
+             "    <Alias Alias=\"HasProperty\">i=46</Alias>\n"
+             "    <Alias Alias=\"HasSubtype\">i=45</Alias>\n"
+             "    <Alias Alias=\"Argument\">i=296</Alias>\n";
+    for (int group = 0; group < groupCount; ++group) {
+        out += "    <Alias Alias=\"SyntheticDataType" + QByteArray::number(group) + "\">"
+               + nodeId(group * GroupSize + 1 + DataTypeOffset) + "</Alias>\n";
+    }
+    out += "  </Aliases>\n";
+
+    for (int group = 0; group < groupCount; ++group) {
+        writeGroup(out, group);
+        if (out.size() > 1024 * 1024) {
+            file.write(out);
+            out.clear();
+        }
+    }
+    out += "</UANodeSet>\n";
+    file.write(out);
+
+    if (!file.commit()) {
+        qWarning() << "Could not write synthetic NodeSet" << filePath << file.errorString();
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,24 @@
+// SPDX-FileCopyrightText: 2025 Marius Dege <marius.dege@basyskom.com>
+// SPDX-FileCopyrightText: 2024 Marius Dege <marius.dege@basyskom.com>
+// SPDX-FileCopyrightText: 2024 basysKom GmbH
+
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#ifndef SYNTHETICNODESET_H
+#define SYNTHETICNODESET_H
+
+#include <QString>
+
+// Writes a self-contained NodeSet2.xml with roughly nodeCount nodes in namespace 1. The nodes
+// come in groups of 20 that mirror a companion spec: an ObjectType with its instances, their
+// variables, a DataType with definition fields, a VariableType and a Method with arguments.
+// Reference chains are kept shallow, so the recursive reference resolution does not run out
+// of stack on large sets.
+class SyntheticNodeSet
+{
+public:
+    static QString modelUri(int nodeCount);
+    static bool write(const QString& filePath, int nodeCount);
+};
+
+#endif // SYNTHETICNODESET_H
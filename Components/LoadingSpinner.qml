@@ -6,6 +6,7 @@
 
 import QtQuick
 import QtQuick.Controls
+import Utils 1.0
 
 Item {
     id: globalLoadingSpinner
@@ -13,6 +14,8 @@ Item {
     anchors.fill: parent
     visible: false
 
+    property alias text: statusLabel.text
+
     signal showSpinner()
     signal hideSpinner()
 
@@ -26,10 +29,20 @@ Item {
     }
 
     BusyIndicator {
+        id: busyIndicator
         anchors.centerIn: parent
         running: globalLoadingSpinner.visible
 
         width: 80
         height: 80
     }
+
+    Label {
+        id: statusLabel
+
+        anchors.top: busyIndicator.bottom
+        anchors.topMargin: Utils.defaultSpacing
+        anchors.horizontalCenter: parent.horizontalCenter
+        visible: text !== ""
+    }
 }
@@ -6,7 +6,6 @@
 
 import QtQuick
 import QtQuick.Window 2.12
-import Qt.labs.folderlistmodel 2.6
 import QtQuick.Controls 2.15
 import QtQuick.Dialogs
 import QtQuick.Layouts 1.15
@@ -55,6 +54,7 @@ Window {
     LoadingSpinner {
         id: globalLoadingSpinner
         z:3
+        text: core.loadStatus
     }
 
     Dialog {
@@ -93,7 +93,7 @@ Window {
                 globalLoadingSpinner.showSpinner();
                 initDialog.close();
                 Qt.callLater(function() {
-                    core.selectNodeSetXML(folderModel.get(companionDropdown.currentIndex, "filePath"));
+                    core.selectNodeSetXML(core.companionSpecs[companionDropdown.currentIndex].filePath);
                 });
             } else {
                 globalLoadingSpinner.showSpinner();
@@ -182,7 +182,7 @@ Window {
                 anchors.left: parent.left
                 anchors.right: parent.right
 
-                model: folderModel
+                model: core.companionSpecs
                 textRole: "fileName"
                 labelText: "Companion Spec:"
             }
@@ -197,13 +197,10 @@ Window {
                 text: core.projectName
             }
 
-            FolderListModel {
-                id: folderModel
-
-                property url folderUrl: "file://" + core.nodeSetPath
-
-                folder: folderUrl
-                showDirs: true
+            LabeledCheckbox {
+                labelText: "Load Dependencies On Demand"
+                checked: core.lazyLoadDependencies
+                onToggled: (checked) => core.lazyLoadDependencies = checked
             }
         }
 
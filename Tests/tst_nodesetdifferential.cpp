@@ -0,0 +1,225 @@
+// SPDX-FileCopyrightText: 2025 Marius Dege <marius.dege@basyskom.com>
+// SPDX-FileCopyrightText: 2024 Marius Dege <marius.dege@basyskom.com>
+// SPDX-FileCopyrightText: 2024 basysKom GmbH
+
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+// Parses the fixture with NodeSetTokenizer and with QXmlStreamReader and compares the resolved
+// results, so a divergence of the tokenizer or a silent fallback to QXmlStreamReader fails. Also
+// compares lazily loaded dependencies with fully parsed ones, parallel with serial linking, and
+// checks that snapshots are read back unchanged.
+
+#include "nodesetresolver.h"
+#include "nodesetsnapshot.h"
+#include "nodesettokenizer.h"
+#include "uanodesetparser.h"
+
+#include <QBuffer>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <utility>
+
+class NodeSetDifferentialTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void tokenizerReadsFixture_data();
+    void tokenizerReadsFixture();
+    void identicalSnapshots_data();
+    void identicalSnapshots();
+    void lineEndingsDoNotMatter();
+    void lazyDependencies();
+    void parallelLinking();
+    void snapshotRoundTrip();
+
+private:
+    QTemporaryDir m_dir;
+    QString m_lfFile;
+    QString m_crlfFile;
+
+    void addFileRows();
+    static QByteArray resolvedSnapshot(const QString& file, bool fastTokenizer);
+    static QByteArray snapshot(const QMap<QString, std::shared_ptr<UANodeSet>>& nodeSets);
+    QByteArray resolvedValves(bool lazyDependency) const;
+    QByteArray resolvedFixtures(bool parallelLinking) const;
+};
+
+void NodeSetDifferentialTest::initTestCase()
+{
+    QFile fixture(QStringLiteral(TEST_DATA_DIR "/Differential.NodeSet2.xml"));
+    QVERIFY2(fixture.open(QIODevice::ReadOnly), qPrintable(fixture.errorString()));
+    QVERIFY(m_dir.isValid());
+
+    // Written from the fixture, so the test does not depend on how git checked it out.
+    QByteArray lf = fixture.readAll();
+    lf.replace("\r\n", "\n");
+    QByteArray crlf = lf;
+    crlf.replace("\n", "\r\n");
+
+    m_lfFile = m_dir.filePath(QStringLiteral("Differential.LF.NodeSet2.xml"));
+    m_crlfFile = m_dir.filePath(QStringLiteral("Differential.CRLF.NodeSet2.xml"));
+    for (const auto& [path, content] : {std::pair(m_lfFile, lf), std::pair(m_crlfFile, crlf)}) {
+        QFile file(path);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        QCOMPARE(file.write(content), qint64(content.size()));
+    }
+}
+
+void NodeSetDifferentialTest::addFileRows()
+{
+    QTest::addColumn<QString>("file");
+    QTest::newRow("lf") << m_lfFile;
+    QTest::newRow("crlf") << m_crlfFile;
+}
+
+QByteArray NodeSetDifferentialTest::resolvedSnapshot(const QString& file, bool fastTokenizer)
+{
+    std::shared_ptr<UANodeSet> nodeSet = std::make_shared<UANodeSet>();
+    UaNodeSetParser parser;
+    parser.setUseFastTokenizer(fastTokenizer);
+    if (!parser.parse(file, nodeSet.get()))
+        return QByteArray();
+
+    const QMap<QString, std::shared_ptr<UANodeSet>> nodeSets{
+        {nodeSet->getNameSpaceUri(), nodeSet}};
+    NodeSetResolver(nodeSets).resolve();
+    return snapshot(nodeSets);
+}
+
+QByteArray NodeSetDifferentialTest::snapshot(
+    const QMap<QString, std::shared_ptr<UANodeSet>>& nodeSets)
+{
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+    if (!NodeSetSnapshot::write(&buffer, nodeSets))
+        return QByteArray();
+    return buffer.data();
+}
+
+// Resolves the Valves model together with the fixture it depends on, like NodeSetLoader: the
+// selected model is parsed and the dependency either parsed as well or only indexed.
+QByteArray NodeSetDifferentialTest::resolvedValves(bool lazyDependency) const
+{
+    std::shared_ptr<UANodeSet> dependency = std::make_shared<UANodeSet>();
+    std::shared_ptr<UANodeSet> valves = std::make_shared<UANodeSet>();
+    UaNodeSetParser parser;
+    const bool dependencyRead = lazyDependency ? parser.index(m_lfFile, dependency.get())
+                                               : parser.parse(m_lfFile, dependency.get());
+    if (!dependencyRead || dependency->isLazy() != lazyDependency
+        || !parser.parse(QStringLiteral(TEST_DATA_DIR "/Differential.Valves.NodeSet2.xml"),
+                         valves.get()))
+        return QByteArray();
+
+    const QMap<QString, std::shared_ptr<UANodeSet>> nodeSets{
+        {dependency->getNameSpaceUri(), dependency}, {valves->getNameSpaceUri(), valves}};
+    NodeSetResolver(nodeSets).resolve();
+    // Lazy nodes the resolver did not reach stay unresolved, so only the selected model, which
+    // carries the resolved datatypes and inherited fields of the dependency, is compared.
+    return snapshot({{valves->getNameSpaceUri(), valves}});
+}
+
+void NodeSetDifferentialTest::tokenizerReadsFixture_data()
+{
+    addFileRows();
+}
+
+// The parser falls back to QXmlStreamReader on any tokenizer error, which would hide that the
+// tokenizer was never compared.
+void NodeSetDifferentialTest::tokenizerReadsFixture()
+{
+    QFETCH(QString, file);
+    QFile input(file);
+    QVERIFY(input.open(QIODevice::ReadOnly));
+    const QByteArray data = input.readAll();
+
+    NodeSetTokenizer tokenizer(data);
+    while (!tokenizer.atEnd())
+        tokenizer.readNext();
+    QVERIFY2(!tokenizer.hasError(),
+             qPrintable(QStringLiteral("%1 at byte %2")
+                            .arg(tokenizer.errorString())
+                            .arg(tokenizer.position())));
+}
+
+void NodeSetDifferentialTest::identicalSnapshots_data()
+{
+    addFileRows();
+}
+
+void NodeSetDifferentialTest::identicalSnapshots()
+{
+    QFETCH(QString, file);
+    const QByteArray tokenized = resolvedSnapshot(file, true);
+    const QByteArray streamed = resolvedSnapshot(file, false);
+    QVERIFY(!tokenized.isEmpty());
+    QVERIFY(!streamed.isEmpty());
+    QCOMPARE(tokenized, streamed);
+}
+
+void NodeSetDifferentialTest::lineEndingsDoNotMatter()
+{
+    QCOMPARE(resolvedSnapshot(m_crlfFile, true), resolvedSnapshot(m_lfFile, true));
+}
+
+// Resolving loads the dependency nodes on demand over several rounds, among them a datatype with
+// the string NodeId ns=2;s=Flow&amp;Pressure. The selected model has to come out as if the
+// dependency had been parsed in full.
+void NodeSetDifferentialTest::lazyDependencies()
+{
+    const QByteArray lazy = resolvedValves(true);
+    const QByteArray eager = resolvedValves(false);
+    QVERIFY(!lazy.isEmpty());
+    QVERIFY(!eager.isEmpty());
+    QCOMPARE(lazy, eager);
+}
+
+// Both fixtures parsed in full and resolved with the given link phase, all nodesets are compared.
+QByteArray NodeSetDifferentialTest::resolvedFixtures(bool parallelLinking) const
+{
+    std::shared_ptr<UANodeSet> dependency = std::make_shared<UANodeSet>();
+    std::shared_ptr<UANodeSet> valves = std::make_shared<UANodeSet>();
+    UaNodeSetParser parser;
+    if (!parser.parse(m_lfFile, dependency.get())
+        || !parser.parse(QStringLiteral(TEST_DATA_DIR "/Differential.Valves.NodeSet2.xml"),
+                         valves.get()))
+        return QByteArray();
+
+    const QMap<QString, std::shared_ptr<UANodeSet>> nodeSets{
+        {dependency->getNameSpaceUri(), dependency}, {valves->getNameSpaceUri(), valves}};
+    NodeSetResolver resolver(nodeSets);
+    resolver.setParallelLinking(parallelLinking);
+    resolver.resolve();
+    return snapshot(nodeSets);
+}
+
+// The parallel link phase has to give the same result as linking during the ordered walk.
+void NodeSetDifferentialTest::parallelLinking()
+{
+    const QByteArray parallel = resolvedFixtures(true);
+    const QByteArray serial = resolvedFixtures(false);
+    QVERIFY(!parallel.isEmpty());
+    QVERIFY(!serial.isEmpty());
+    QCOMPARE(parallel, serial);
+}
+
+// A loaded snapshot has to be written back byte for byte, the variable names included
+void NodeSetDifferentialTest::snapshotRoundTrip()
+{
+    const QByteArray written = resolvedFixtures(true);
+    QVERIFY(!written.isEmpty());
+
+    QBuffer buffer;
+    buffer.setData(written);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+    QMap<QString, std::shared_ptr<UANodeSet>> nodeSets;
+    QVERIFY(NodeSetSnapshot::read(&buffer, nodeSets));
+    QCOMPARE(nodeSets.size(), 2);
+    QCOMPARE(snapshot(nodeSets), written);
+}
+
+QTEST_GUILESS_MAIN(NodeSetDifferentialTest)
+#include "tst_nodesetdifferential.moc"
@@ -0,0 +1,33 @@
+// SPDX-FileCopyrightText: 2025 Marius Dege <marius.dege@basyskom.com>
+// SPDX-FileCopyrightText: 2024 Marius Dege <marius.dege@basyskom.com>
+// SPDX-FileCopyrightText: 2024 basysKom GmbH
+
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "Util/Arena.h"
+#include <algorithm>
+#include <cstdint>
+
+Arena::Arena(size_t blockSize)
+    : m_blockSize(blockSize)
+{}
+
+void* Arena::allocate(size_t size, size_t alignment)
+{
+    const size_t padding = (alignment - reinterpret_cast<std::uintptr_t>(m_current) % alignment)
+                           % alignment;
+    if (!m_current || padding + size > m_remaining) {
+        // oversized requests get a block of their own
+        const size_t blockSize = std::max(m_blockSize, size + alignment);
+        m_blocks.push_back(std::unique_ptr<char[]>(new char[blockSize]));
+        m_current = m_blocks.back().get();
+        m_remaining = blockSize;
+        return allocate(size, alignment);
+    }
+
+    char* result = m_current + padding;
+    m_current = result + size;
+    m_remaining -= padding + size;
+    m_allocatedBytes += size;
+    return result;
+}
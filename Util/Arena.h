@@ -0,0 +1,77 @@
+// SPDX-FileCopyrightText: 2025 Marius Dege <marius.dege@basyskom.com>
+// SPDX-FileCopyrightText: 2024 Marius Dege <marius.dege@basyskom.com>
+// SPDX-FileCopyrightText: 2024 basysKom GmbH
+
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#pragma once
+
+#include <QtGlobal>
+#include <memory>
+#include <vector>
+
+// Bump allocator for objects that live and die together, like the nodes of one nodeset.
+// Memory is taken from large blocks and only released when the arena is destroyed.
+// Not thread safe, an arena must only be used by one thread at a time.
+class Arena
+{
+public:
+    explicit Arena(size_t blockSize = 64 * 1024);
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    void* allocate(size_t size, size_t alignment);
+
+    size_t allocatedBytes() const { return m_allocatedBytes; }
+    size_t blockCount() const { return m_blocks.size(); }
+
+private:
+    const size_t m_blockSize;
+    std::vector<std::unique_ptr<char[]>> m_blocks;
+    char* m_current = nullptr;
+    size_t m_remaining = 0;
+    size_t m_allocatedBytes = 0;
+};
+
+// Allocator for std::allocate_shared. Every copy keeps the arena alive, so objects and their
+// control blocks stay valid as long as any shared_ptr to them exists, even after the owner of
+// the arena is gone.
+template<typename T>
+class ArenaAllocator
+{
+public:
+    using value_type = T;
+
+    explicit ArenaAllocator(std::shared_ptr<Arena> arena)
+        : m_arena(std::move(arena))
+    {}
+
+    template<typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other)
+        : m_arena(other.arena())
+    {}
+
+    T* allocate(size_t count)
+    {
+        return static_cast<T*>(m_arena->allocate(count * sizeof(T), alignof(T)));
+    }
+
+    // the memory is released together with the arena
+    void deallocate(T*, size_t) noexcept {}
+
+    const std::shared_ptr<Arena>& arena() const { return m_arena; }
+
+    template<typename U>
+    bool operator==(const ArenaAllocator<U>& other) const
+    {
+        return m_arena == other.arena();
+    }
+    template<typename U>
+    bool operator!=(const ArenaAllocator<U>& other) const
+    {
+        return m_arena != other.arena();
+    }
+
+private:
+    std::shared_ptr<Arena> m_arena;
+};
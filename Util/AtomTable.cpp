@@ -0,0 +1,73 @@
+// SPDX-FileCopyrightText: 2025 Marius Dege <marius.dege@basyskom.com>
+// SPDX-FileCopyrightText: 2024 Marius Dege <marius.dege@basyskom.com>
+// SPDX-FileCopyrightText: 2024 basysKom GmbH
+
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "Util/AtomTable.h"
+
+AtomTable::AtomTable()
+{
+    m_strings.append(QString());
+    m_atoms.insert(QString(), 0);
+}
+
+AtomTable* AtomTable::instance()
+{
+    // never destroyed, atoms may still be used by static objects during shutdown
+    static AtomTable* table = new AtomTable();
+    return table;
+}
+
+Atom AtomTable::intern(const QString& string)
+{
+    if (string.isEmpty())
+        return 0;
+
+    {
+        QReadLocker locker(&m_lock);
+        const auto it = m_atoms.constFind(string);
+        if (it != m_atoms.constEnd()) {
+            m_savedBytes.fetch_add(
+                string.size() * qsizetype(sizeof(QChar)), std::memory_order_relaxed);
+            return it.value();
+        }
+    }
+
+    QWriteLocker locker(&m_lock);
+    // another thread might have added it in the meantime
+    const auto it = m_atoms.constFind(string);
+    if (it != m_atoms.constEnd())
+        return it.value();
+
+    const Atom atom = Atom(m_strings.size());
+    m_strings.append(string);
+    m_atoms.insert(string, atom);
+    return atom;
+}
+
+Atom AtomTable::find(const QString& string) const
+{
+    if (string.isEmpty())
+        return 0;
+
+    QReadLocker locker(&m_lock);
+    return m_atoms.value(string, NoAtom);
+}
+
+QString AtomTable::string(Atom atom) const
+{
+    QReadLocker locker(&m_lock);
+    return m_strings.value(atom);
+}
+
+qsizetype AtomTable::size() const
+{
+    QReadLocker locker(&m_lock);
+    return m_strings.size();
+}
+
+qint64 AtomTable::savedBytes() const
+{
+    return m_savedBytes.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,58 @@
+// SPDX-FileCopyrightText: 2025 Marius Dege <marius.dege@basyskom.com>
+// SPDX-FileCopyrightText: 2024 Marius Dege <marius.dege@basyskom.com>
+// SPDX-FileCopyrightText: 2024 basysKom GmbH
+
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#pragma once
+
+#include "Util/Utils.h"
+#include <QHash>
+#include <QList>
+#include <QReadWriteLock>
+#include <QString>
+#include <atomic>
+#include <limits>
+
+// Id of an interned string. Atom 0 is the empty string.
+using Atom = quint32;
+
+// Process wide table of strings that repeat across all nodes, like reference types, namespace
+// URIs and datatype names. Every string is stored once and nodes only keep its 32 bit id, so
+// comparing them is an integer compare. Atoms are never released. Thread safe.
+class AtomTable
+{
+public:
+    static AtomTable* instance();
+
+    // Never returned for a string, find() gives it for strings that are not interned
+    static constexpr Atom NoAtom = std::numeric_limits<Atom>::max();
+
+    // For strings that are stored in a node or reference, a hit counts as saved memory
+    Atom intern(const QString& string);
+    // For lookups, neither inserts nor counts. NoAtom if the string is not interned.
+    Atom find(const QString& string) const;
+    QString string(Atom atom) const;
+
+    qsizetype size() const;
+    // String data that would have been allocated again for every duplicate stored with intern()
+    qint64 savedBytes() const;
+
+private:
+    AtomTable();
+
+    mutable QReadWriteLock m_lock;
+    QHash<QString, Atom> m_atoms;
+    QList<QString> m_strings;
+    std::atomic<qint64> m_savedBytes = 0;
+};
+
+// Atoms of the strings that are compared while resolving and building the models.
+namespace Atoms {
+inline const Atom HasSubtype = AtomTable::instance()->intern(XmlTags::HasSubtype);
+inline const Atom HasProperty = AtomTable::instance()->intern(XmlTags::HasProperty);
+inline const Atom HasComponent = AtomTable::instance()->intern(XmlTags::HasComponent);
+inline const Atom HasTypeDefinition = AtomTable::instance()->intern(XmlTags::HasTypeDefinition);
+inline const Atom HasModellingRule = AtomTable::instance()->intern(XmlTags::HasModellingRule);
+inline const Atom HasEncoding = AtomTable::instance()->intern(XmlTags::HasEncoding);
+} // namespace Atoms
@@ -0,0 +1,238 @@
+// SPDX-FileCopyrightText: 2025 Marius Dege <marius.dege@basyskom.com>
+// SPDX-FileCopyrightText: 2024 Marius Dege <marius.dege@basyskom.com>
+// SPDX-FileCopyrightText: 2024 basysKom GmbH
+
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "Util/DecompressingDevice.h"
+#include <QDebug>
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+namespace {
+constexpr qint64 InputChunkSize = 64 * 1024;
+
+const QString GzipSuffix = QStringLiteral(".gz");
+const QString ZstdSuffix = QStringLiteral(".zst");
+} // namespace
+
+struct DecompressingDevice::Decoder
+{
+#ifdef HAVE_ZLIB
+    z_stream zlib = {};
+    bool zlibInitialized = false;
+#endif
+#ifdef HAVE_ZSTD
+    ZSTD_DStream* zstd = nullptr;
+#endif
+
+    ~Decoder()
+    {
+#ifdef HAVE_ZLIB
+        if (zlibInitialized)
+            inflateEnd(&zlib);
+#endif
+#ifdef HAVE_ZSTD
+        ZSTD_freeDStream(zstd);
+#endif
+    }
+};
+
+DecompressingDevice::Compression DecompressingDevice::compression(const QString& filePath)
+{
+    if (filePath.endsWith(GzipSuffix, Qt::CaseInsensitive))
+        return Compression::Gzip;
+    if (filePath.endsWith(ZstdSuffix, Qt::CaseInsensitive))
+        return Compression::Zstd;
+    return Compression::None;
+}
+
+bool DecompressingDevice::isSupported(Compression compression)
+{
+    switch (compression) {
+    case Compression::None:
+        return true;
+    case Compression::Gzip:
+#ifdef HAVE_ZLIB
+        return true;
+#else
+        return false;
+#endif
+    case Compression::Zstd:
+#ifdef HAVE_ZSTD
+        return true;
+#else
+        return false;
+#endif
+    }
+    return false;
+}
+
+QString DecompressingDevice::withoutCompressionSuffix(const QString& fileName)
+{
+    switch (compression(fileName)) {
+    case Compression::Gzip:
+        return fileName.chopped(GzipSuffix.size());
+    case Compression::Zstd:
+        return fileName.chopped(ZstdSuffix.size());
+    case Compression::None:
+        break;
+    }
+    return fileName;
+}
+
+DecompressingDevice::DecompressingDevice(const QString& filePath, QObject* parent)
+    : QIODevice(parent)
+    , m_file(filePath)
+    , m_compression(compression(filePath))
+{}
+
+DecompressingDevice::~DecompressingDevice()
+{
+    close();
+}
+
+bool DecompressingDevice::open(OpenMode mode)
+{
+    if (mode != ReadOnly) {
+        setErrorString(QStringLiteral("Compressed files can only be read"));
+        return false;
+    }
+    if (!isSupported(m_compression)) {
+        setErrorString(QStringLiteral("Compression not supported by this build"));
+        return false;
+    }
+    if (!m_file.open(ReadOnly)) {
+        setErrorString(m_file.errorString());
+        return false;
+    }
+
+    m_decoder = std::make_unique<Decoder>();
+    bool initialized = m_compression == Compression::None;
+#ifdef HAVE_ZLIB
+    if (m_compression == Compression::Gzip) {
+        // 32 enables the automatic gzip/zlib header detection
+        initialized = inflateInit2(&m_decoder->zlib, MAX_WBITS + 32) == Z_OK;
+        m_decoder->zlibInitialized = initialized;
+    }
+#endif
+#ifdef HAVE_ZSTD
+    if (m_compression == Compression::Zstd) {
+        m_decoder->zstd = ZSTD_createDStream();
+        initialized = m_decoder->zstd && !ZSTD_isError(ZSTD_initDStream(m_decoder->zstd));
+    }
+#endif
+    if (!initialized) {
+        setErrorString(QStringLiteral("Cannot initialize the decompression"));
+        m_file.close();
+        m_decoder.reset();
+        return false;
+    }
+
+    m_input.clear();
+    m_inputPosition = 0;
+    m_finished = false;
+    return QIODevice::open(mode | Unbuffered);
+}
+
+void DecompressingDevice::close()
+{
+    if (!isOpen())
+        return;
+    QIODevice::close();
+    m_decoder.reset();
+    m_file.close();
+    m_input.clear();
+}
+
+bool DecompressingDevice::isSequential() const
+{
+    return true;
+}
+
+bool DecompressingDevice::atEnd() const
+{
+    return m_finished && QIODevice::atEnd();
+}
+
+bool DecompressingDevice::fillInput()
+{
+    if (m_inputPosition < m_input.size())
+        return true;
+    m_input = m_file.read(InputChunkSize);
+    m_inputPosition = 0;
+    return !m_input.isEmpty();
+}
+
+qint64 DecompressingDevice::readData(char* data, qint64 maxSize)
+{
+    if (m_finished || maxSize <= 0)
+        return m_finished ? -1 : 0;
+
+    if (m_compression == Compression::None) {
+        const qint64 read = m_file.read(data, maxSize);
+        if (read <= 0)
+            m_finished = true;
+        return read;
+    }
+
+    qint64 produced = 0;
+    while (produced < maxSize) {
+        if (!fillInput()) {
+            // the compressed data ended, whatever was decoded is all there is
+            m_finished = true;
+            break;
+        }
+        const char* input = m_input.constData() + m_inputPosition;
+        const qsizetype inputSize = m_input.size() - m_inputPosition;
+
+#ifdef HAVE_ZLIB
+        if (m_compression == Compression::Gzip) {
+            z_stream& zlib = m_decoder->zlib;
+            zlib.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input));
+            zlib.avail_in = static_cast<uInt>(inputSize);
+            zlib.next_out = reinterpret_cast<Bytef*>(data + produced);
+            zlib.avail_out = static_cast<uInt>(qMin<qint64>(maxSize - produced, 1 << 30));
+            const uInt outputSize = zlib.avail_out;
+            const int result = inflate(&zlib, Z_NO_FLUSH);
+            m_inputPosition += inputSize - zlib.avail_in;
+            produced += outputSize - zlib.avail_out;
+            if (result == Z_STREAM_END) {
+                // concatenated gzip members continue with the next one
+                inflateReset(&zlib);
+            } else if (result != Z_OK && result != Z_BUF_ERROR) {
+                setErrorString(QString::fromLatin1(zlib.msg ? zlib.msg : "inflate failed"));
+                qWarning() << "Cannot decompress" << m_file.fileName() << errorString();
+                m_finished = true;
+                return produced > 0 ? produced : -1;
+            }
+        }
+#endif
+#ifdef HAVE_ZSTD
+        if (m_compression == Compression::Zstd) {
+            ZSTD_inBuffer in = {input, static_cast<size_t>(inputSize), 0};
+            ZSTD_outBuffer out = {data + produced, static_cast<size_t>(maxSize - produced), 0};
+            const size_t result = ZSTD_decompressStream(m_decoder->zstd, &out, &in);
+            if (ZSTD_isError(result)) {
+                setErrorString(QString::fromLatin1(ZSTD_getErrorName(result)));
+                qWarning() << "Cannot decompress" << m_file.fileName() << errorString();
+                m_finished = true;
+                return produced > 0 ? produced : -1;
+            }
+            m_inputPosition += in.pos;
+            produced += out.pos;
+        }
+#endif
+    }
+    return produced > 0 || !m_finished ? produced : -1;
+}
+
+qint64 DecompressingDevice::writeData(const char*, qint64)
+{
+    return -1;
+}
@@ -0,0 +1,51 @@
+// SPDX-FileCopyrightText: 2025 Marius Dege <marius.dege@basyskom.com>
+// SPDX-FileCopyrightText: 2024 Marius Dege <marius.dege@basyskom.com>
+// SPDX-FileCopyrightText: 2024 basysKom GmbH
+
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#pragma once
+
+#include <QByteArray>
+#include <QFile>
+#include <QIODevice>
+#include <memory>
+
+// Sequential, read-only device that decompresses a .gz or .zst file while it is read, so the
+// XML reader can be fed without inflating the whole file into memory first. gzip needs zlib
+// (HAVE_ZLIB), zstd needs libzstd (HAVE_ZSTD).
+class DecompressingDevice : public QIODevice
+{
+public:
+    enum class Compression { None, Gzip, Zstd };
+
+    // Detected by the file suffix
+    static Compression compression(const QString& filePath);
+    static bool isSupported(Compression compression);
+    // "Opc.Ua.Di.NodeSet2.xml.gz" -> "Opc.Ua.Di.NodeSet2.xml"
+    static QString withoutCompressionSuffix(const QString& fileName);
+
+    explicit DecompressingDevice(const QString& filePath, QObject* parent = nullptr);
+    ~DecompressingDevice() override;
+
+    bool open(OpenMode mode) override;
+    void close() override;
+    bool isSequential() const override;
+    bool atEnd() const override;
+
+protected:
+    qint64 readData(char* data, qint64 maxSize) override;
+    qint64 writeData(const char* data, qint64 maxSize) override;
+
+private:
+    struct Decoder;
+
+    QFile m_file;
+    Compression m_compression = Compression::None;
+    std::unique_ptr<Decoder> m_decoder;
+    QByteArray m_input;
+    qsizetype m_inputPosition = 0;
+    bool m_finished = false;
+
+    bool fillInput();
+};
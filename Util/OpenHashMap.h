@@ -0,0 +1,112 @@
+// SPDX-FileCopyrightText: 2025 Marius Dege <marius.dege@basyskom.com>
+// SPDX-FileCopyrightText: 2024 Marius Dege <marius.dege@basyskom.com>
+// SPDX-FileCopyrightText: 2024 basysKom GmbH
+
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#pragma once
+
+#include <QHashFunctions>
+#include <QList>
+
+// Hash map with open addressing and linear probing. All entries live in one flat array, so a
+// lookup is a hash and usually a single cache line. Entries can't be removed, which keeps the
+// probing free of tombstones. Key needs operator== and a qHash overload.
+template<typename Key, typename Value>
+class OpenHashMap
+{
+public:
+    qsizetype size() const { return m_size; }
+    bool isEmpty() const { return m_size == 0; }
+
+    void clear()
+    {
+        m_slots.clear();
+        m_size = 0;
+    }
+
+    void reserve(qsizetype size)
+    {
+        qsizetype capacity = MinimumCapacity;
+        while (capacity * MaxLoadPercent / 100 < size)
+            capacity *= 2;
+        if (capacity > m_slots.size())
+            rehash(capacity);
+    }
+
+    // Inserts or overwrites the value for key.
+    void insert(const Key& key, const Value& value)
+    {
+        if ((m_size + 1) * 100 > m_slots.size() * MaxLoadPercent)
+            rehash(m_slots.isEmpty() ? MinimumCapacity : m_slots.size() * 2);
+
+        Slot& slot = m_slots[probe(key)];
+        if (!slot.used) {
+            slot.used = true;
+            slot.key = key;
+            ++m_size;
+        }
+        slot.value = value;
+    }
+
+    const Value* find(const Key& key) const
+    {
+        if (m_slots.isEmpty())
+            return nullptr;
+        const Slot& slot = m_slots.at(probe(key));
+        return slot.used ? &slot.value : nullptr;
+    }
+
+    bool contains(const Key& key) const { return find(key) != nullptr; }
+
+    Value value(const Key& key, const Value& defaultValue = Value()) const
+    {
+        const Value* found = find(key);
+        return found ? *found : defaultValue;
+    }
+
+    template<typename Function>
+    void forEach(Function function) const
+    {
+        for (const Slot& slot : m_slots) {
+            if (slot.used)
+                function(slot.key, slot.value);
+        }
+    }
+
+private:
+    static constexpr qsizetype MinimumCapacity = 16;
+    static constexpr qsizetype MaxLoadPercent = 70;
+
+    struct Slot
+    {
+        Key key{};
+        Value value{};
+        bool used = false;
+    };
+
+    QList<Slot> m_slots;
+    qsizetype m_size = 0;
+
+    // Index of the slot holding key, or of the free slot where it would be inserted.
+    // The capacity is always a power of two.
+    qsizetype probe(const Key& key) const
+    {
+        const qsizetype mask = m_slots.size() - 1;
+        qsizetype index = qsizetype(qHash(key, 0) & size_t(mask));
+        while (m_slots.at(index).used && !(m_slots.at(index).key == key))
+            index = (index + 1) & mask;
+        return index;
+    }
+
+    void rehash(qsizetype capacity)
+    {
+        QList<Slot> oldSlots = std::move(m_slots);
+        m_slots = QList<Slot>(capacity);
+        m_size = 0;
+        for (Slot& slot : oldSlots) {
+            if (slot.used)
+                insert(slot.key, std::move(slot.value));
+        }
+    }
+};
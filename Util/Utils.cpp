@@ -146,6 +146,11 @@ QString Utils::lowerFirstChar(const QString& str) const
     return str;
 }
 
+std::string Utils::toStdString(QByteArrayView utf8)
+{
+    return std::string(utf8.data(), size_t(utf8.size()));
+}
+
 QString Utils::sanitizeName(const QString& name) const
 {
     // We need to make sure that the variable names are valid identifiers for C
@@ -6,16 +6,21 @@
 
 #pragma once
 
+#include <QByteArrayView>
 #include <QChar>
 #include <QDebug>
 #include <QMap>
 #include <QObject>
 
+#include <string>
+
 namespace XmlTags {
 inline const QString Models = QStringLiteral("Models");
 inline const QString RequiredModel = QStringLiteral("RequiredModel");
 inline const QString Model = QStringLiteral("Model");
 inline const QString ModelUri = QStringLiteral("ModelUri");
+inline const QString Version = QStringLiteral("Version");
+inline const QString PublicationDate = QStringLiteral("PublicationDate");
 inline const QString Namespace = QStringLiteral("Namespace");
 inline const QString Uri = QStringLiteral("Uri");
 inline const QString UANode = QStringLiteral("UANode");
@@ -25,6 +30,7 @@ inline const QString UAVariable = QStringLiteral("UAVariable");
 inline const QString UAMethod = QStringLiteral("UAMethod");
 inline const QString UAVariableType = QStringLiteral("UAVariableType");
 inline const QString UAObjectType = QStringLiteral("UAObjectType");
+inline const QString UAReferenceType = QStringLiteral("UAReferenceType");
 inline const QString References = QStringLiteral("References");
 inline const QString Reference = QStringLiteral("Reference");
 inline const QString ReferenceType = QStringLiteral("ReferenceType");
@@ -57,6 +63,179 @@ inline const QString HasTypeDefinition = QStringLiteral("HasTypeDefinition");
 inline const QString HasModellingRule = QStringLiteral("HasModellingRule");
 inline const QString HasEncoding = QStringLiteral("HasEncoding");
 
+// Element and attribute names the NodeSet parser dispatches on.
+enum class Token : quint8 {
+    Unknown,
+    Alias,
+    Aliases,
+    ArrayDimensions,
+    Body,
+    BrowseName,
+    DataType,
+    Definition,
+    Description,
+    DisplayName,
+    ExtensionObject,
+    Field,
+    Identifier,
+    IsAbstract,
+    IsForward,
+    ListOfExtensionObject,
+    Model,
+    ModelUri,
+    Models,
+    Name,
+    NodeId,
+    ParentNodeId,
+    Reference,
+    ReferenceType,
+    References,
+    RequiredModel,
+    TypeId,
+    UADataType,
+    UAMethod,
+    UANodeSet,
+    UAObject,
+    UAObjectType,
+    UAReferenceType,
+    UAVariable,
+    UAVariableType,
+    Value,
+    ValueRank,
+};
+
+inline char16_t codeUnit(QChar c)
+{
+    return c.unicode();
+}
+
+inline char16_t codeUnit(char c)
+{
+    return static_cast<uchar>(c);
+}
+
+// Compares a name against an ASCII literal without converting the name to a QString.
+template<typename View>
+inline bool equals(const View& name, const char* literal)
+{
+    for (qsizetype i = 0; i < name.size(); ++i) {
+        if (codeUnit(name[i]) != static_cast<uchar>(literal[i]))
+            return false;
+    }
+    return true;
+}
+
+// Maps an element or attribute name to its Token. The names are sorted by length first, so most
+// names are identified or rejected by the first character of one or two candidates. Works on
+// QStringView as well as on UTF-8 views and never allocates.
+template<typename View>
+Token token(const View& name)
+{
+    switch (name.size()) {
+    case 4:
+        if (equals(name, "Body"))
+            return Token::Body;
+        if (equals(name, "Name"))
+            return Token::Name;
+        break;
+    case 5:
+        if (equals(name, "Alias"))
+            return Token::Alias;
+        if (equals(name, "Field"))
+            return Token::Field;
+        if (equals(name, "Model"))
+            return Token::Model;
+        if (equals(name, "Value"))
+            return Token::Value;
+        break;
+    case 6:
+        if (equals(name, "NodeId"))
+            return Token::NodeId;
+        if (equals(name, "TypeId"))
+            return Token::TypeId;
+        if (equals(name, "Models"))
+            return Token::Models;
+        break;
+    case 7:
+        if (equals(name, "Aliases"))
+            return Token::Aliases;
+        break;
+    case 8:
+        if (equals(name, "DataType"))
+            return Token::DataType;
+        if (equals(name, "ModelUri"))
+            return Token::ModelUri;
+        if (equals(name, "UAObject"))
+            return Token::UAObject;
+        if (equals(name, "UAMethod"))
+            return Token::UAMethod;
+        break;
+    case 9:
+        if (equals(name, "Reference"))
+            return Token::Reference;
+        if (equals(name, "IsForward"))
+            return Token::IsForward;
+        if (equals(name, "UANodeSet"))
+            return Token::UANodeSet;
+        if (equals(name, "ValueRank"))
+            return Token::ValueRank;
+        break;
+    case 10:
+        if (equals(name, "BrowseName"))
+            return Token::BrowseName;
+        if (equals(name, "References"))
+            return Token::References;
+        if (equals(name, "UAVariable"))
+            return Token::UAVariable;
+        if (equals(name, "UADataType"))
+            return Token::UADataType;
+        if (equals(name, "IsAbstract"))
+            return Token::IsAbstract;
+        if (equals(name, "Definition"))
+            return Token::Definition;
+        if (equals(name, "Identifier"))
+            return Token::Identifier;
+        break;
+    case 11:
+        if (equals(name, "DisplayName"))
+            return Token::DisplayName;
+        if (equals(name, "Description"))
+            return Token::Description;
+        break;
+    case 12:
+        if (equals(name, "ParentNodeId"))
+            return Token::ParentNodeId;
+        if (equals(name, "UAObjectType"))
+            return Token::UAObjectType;
+        break;
+    case 13:
+        if (equals(name, "ReferenceType"))
+            return Token::ReferenceType;
+        if (equals(name, "RequiredModel"))
+            return Token::RequiredModel;
+        break;
+    case 14:
+        if (equals(name, "UAVariableType"))
+            return Token::UAVariableType;
+        break;
+    case 15:
+        if (equals(name, "ArrayDimensions"))
+            return Token::ArrayDimensions;
+        if (equals(name, "ExtensionObject"))
+            return Token::ExtensionObject;
+        if (equals(name, "UAReferenceType"))
+            return Token::UAReferenceType;
+        break;
+    case 21:
+        if (equals(name, "ListOfExtensionObject"))
+            return Token::ListOfExtensionObject;
+        break;
+    default:
+        break;
+    }
+    return Token::Unknown;
+}
+
 } // namespace XmlTags
 
 class QQmlEngine;
@@ -115,6 +294,8 @@ public:
     QString removeNamespaceIndexFromName(const QString& nodeName) const;
     QString lowerFirstChar(const QString& str) const;
     QString sanitizeName(const QString& name) const;
+    // For the mustache data, the stored UTF-8 of a node is copied without a QString in between
+    static std::string toStdString(QByteArrayView utf8);
 
     int mainWindowHeight() const;
 
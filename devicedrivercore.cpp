@@ -8,17 +8,18 @@
 #ifdef ENABLE_MODEL_TESTER
 #include <QAbstractItemModelTester>
 #endif
+#include "Util/DecompressingDevice.h"
 #include "Util/Utils.h"
 #include <fstream>
 #include <iostream>
 #include <sstream>
 #include <string>
 #include <QFile>
+#include <QFileInfo>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QString>
-#include <QTimer>
 #include <QVariant>
 
 DeviceDriverCore::DeviceDriverCore()
@@ -33,6 +34,21 @@ DeviceDriverCore::DeviceDriverCore()
 
     m_projectName = QStringLiteral("Untitled");
 
+    connect(&m_loader, &NodeSetLoader::finished, this, &DeviceDriverCore::applyNodeSets);
+    connect(
+        &m_loader,
+        &NodeSetLoader::progressChanged,
+        this,
+        [this](qint64 bytesLoaded, qint64 bytesTotal, qint64 nodesLoaded) {
+            const qreal progress = bytesTotal > 0 ? qreal(bytesLoaded) / bytesTotal : 0.0;
+            setLoadProgress(
+                progress,
+                QStringLiteral("%1 of %2 KiB parsed, %3 nodes")
+                    .arg(bytesLoaded / 1024)
+                    .arg(bytesTotal / 1024)
+                    .arg(nodesLoaded));
+        });
+
 #ifdef ENABLE_MODEL_TESTER
     QAbstractItemModelTester* deviceTypesModeTester = new QAbstractItemModelTester(
         m_deviceTypesModel, QAbstractItemModelTester::FailureReportingMode::Fatal, nullptr);
@@ -53,29 +69,87 @@ DeviceDriverCore::~DeviceDriverCore()
     delete m_rootNodeFilterModel;
 }
 
-void DeviceDriverCore::parseNodeSets(const QString& nodeSetDir)
+NodeSetLoader::Request DeviceDriverCore::loadRequest(const QString& nodeSetDir)
 {
-    // Parse the NodeSet2.xml files and store them in a hash map
-    qDebug() << "Parsing NodeSet XML files..." << nodeSetDir;
-    QStringList requiredModels = findRequiredModels(getNodeSetXmlFile(nodeSetDir));
-    QStringList requiredFiles = findRequiredFiles(requiredModels);
+    // The worker gets everything it needs up front, the catalog is only used on this thread.
+    const UaNodeSetParser::ModelHeader header = UaNodeSetParser::readModelHeader(
+        getNodeSetXmlFile(nodeSetDir));
+
+    NodeSetLoader::Request request;
+    request.modelUris = header.modelUris;
+    request.files = findRequiredFiles(header.modelUris);
+    request.selectedModelUri = header.modelUri;
+    request.lazyLoadDependencies = m_lazyLoadDependencies;
 
-    if (requiredModels.size() != requiredFiles.size()) {
+    if (request.modelUris.size() != request.files.size()) {
         qWarning() << "Required models and files do not match!";
-        return;
+        request.modelUris.clear();
+        request.files.clear();
     }
+    return request;
+}
 
-    for (int i = 0; i < requiredModels.size(); i++) {
-        std::shared_ptr<UANodeSet> nodeSet = std::make_shared<UANodeSet>();
-
-        m_parser.parse(requiredFiles.at(i), nodeSet.get());
-        m_nodeSets.insert(requiredModels.at(i), nodeSet);
+void DeviceDriverCore::applyNodeSets(const NodeSetLoader::Result& result)
+{
+    // Everything the models see changes at once. The worker does not touch the nodesets anymore.
+    m_selectionModel->resetModel();
+    m_nodeSets = result.nodeSets;
+    m_selectedModelUri = result.selectedModelUri;
+
+    //clear the current namespaceMap
+    Utils::instance()->setcurrentNameSpaceMaps(QMap<QString, QMap<int, QString>>());
+    for (const auto& nodeSet : std::as_const(m_nodeSets)) {
+        Utils::instance()->addNameSpaceMap(nodeSet->getNameSpaceUri(), nodeSet->namespaceMap());
     }
 
-    resolveParentNode();
-    resolveReferences();
-    resolveDataTypes();
-    resolveMethods();
+    // the graph and type hierarchy of the previous nodesets are not valid anymore
+    m_nodeGraph = std::make_shared<NodeGraph>(m_nodeSets);
+    m_deviceTypesModel->setNodeGraph(m_nodeGraph);
+    m_selectionModel->setNodeGraph(m_nodeGraph);
+
+    if (m_nodeSets.contains(m_selectedModelUri))
+        m_deviceTypesModel->setupModelData(m_nodeSets[m_selectedModelUri]);
+
+    setLoadProgress(1.0, QString());
+    emit setupFinished();
+}
+
+void DeviceDriverCore::setLoadProgress(qreal progress, const QString& status)
+{
+    if (qFuzzyCompare(m_loadProgress, progress) && m_loadStatus == status)
+        return;
+    m_loadProgress = progress;
+    m_loadStatus = status;
+    emit loadProgressChanged();
+}
+
+qreal DeviceDriverCore::loadProgress() const
+{
+    return m_loadProgress;
+}
+
+QString DeviceDriverCore::loadStatus() const
+{
+    return m_loadStatus;
+}
+
+void DeviceDriverCore::cancelLoading()
+{
+    m_loader.cancel();
+    setLoadProgress(0.0, QString());
+}
+
+bool DeviceDriverCore::lazyLoadDependencies() const
+{
+    return m_lazyLoadDependencies;
+}
+
+void DeviceDriverCore::setLazyLoadDependencies(bool lazyLoadDependencies)
+{
+    if (m_lazyLoadDependencies == lazyLoadDependencies)
+        return;
+    m_lazyLoadDependencies = lazyLoadDependencies;
+    emit lazyLoadDependenciesChanged();
 }
 
 TreeModel* DeviceDriverCore::deviceTypesModel() const
@@ -85,25 +159,20 @@ TreeModel* DeviceDriverCore::deviceTypesModel() const
 
 void DeviceDriverCore::selectNodeSetXML(const QString& nodeSetDir)
 {
-    QTimer::singleShot(10, this, [this, nodeSetDir]() {
-        qDebug() << "Selected NodeSet XML: " << nodeSetDir;
-        m_selectedModelUri.clear();
-        m_nodeSets.clear();
-        m_selectionModel->resetModel();
-        m_currentNodeSetDir = nodeSetDir;
-        parseNodeSets(nodeSetDir);
-
-        //clear the current namespaceMap
-        Utils::instance()->setcurrentNameSpaceMaps(QMap<QString, QMap<int, QString>>());
-        for (const auto& nodeSet : std::as_const(m_nodeSets)) {
-            Utils::instance()->addNameSpaceMap(nodeSet->getNameSpaceUri(), nodeSet->namespaceMap());
-        }
-
-        if (!m_selectedModelUri.isEmpty())
-            m_deviceTypesModel->setupModelData(m_nodeSets[m_selectedModelUri]);
-
-        emit setupFinished();
-    });
+    qDebug() << "Selected NodeSet XML: " << nodeSetDir;
+    m_catalog.refresh();
+    m_currentNodeSetDir = nodeSetDir;
+
+    // Parsing and resolving runs on a worker, the models are updated in applyNodeSets once the
+    // load finished. Selecting another spec while loading cancels the previous load.
+    const NodeSetLoader::Request request = loadRequest(nodeSetDir);
+    if (request.files.isEmpty()) {
+        m_loader.cancel();
+        applyNodeSets(NodeSetLoader::Result());
+        return;
+    }
+    setLoadProgress(0.0, QFileInfo(getNodeSetXmlFile(nodeSetDir)).fileName());
+    m_loader.load(request);
 }
 
 void DeviceDriverCore::addRootNodeToSelectionModel(
@@ -111,10 +180,8 @@ void DeviceDriverCore::addRootNodeToSelectionModel(
 {
     qDebug() << "adding: " << namespaceString << " " << nodeId;
     std::shared_ptr<UANode> node = findNodeById(namespaceString, nodeId);
-    if (node) {
-        std::shared_ptr<UANode> nodeCopy = node->clone();
-        m_selectionModel->addRootNodeToSelection(nodeCopy);
-    }
+    if (node)
+        m_selectionModel->addRootNodeToSelection(node);
 }
 
 void DeviceDriverCore::removeRootNodeFromSelection(const int index)
@@ -237,6 +304,32 @@ void DeviceDriverCore::getVariableAsMustacheArray(
 
     nodeMap["definitionFields"] = definitionFieldsArray;
     jsonObj[QStringLiteral("definitionFields")] = jsonDefinitionFieldsArray;
+
+    // The default value from the NodeSet becomes a static initialiser, so the read callback only
+    // copies it instead of building it on every read.
+    std::shared_ptr<UAVariable> variableNode = std::dynamic_pointer_cast<UAVariable>(
+        item->getNode());
+    if (variableNode && variableNode->value().hasStaticInitializer()) {
+        const UAValue& value = variableNode->value();
+        std::unordered_map<std::string, mustache::data> defaultValue;
+        QJsonObject jsonDefaultValue;
+
+        defaultValue["cType"] = value.cTypeName().toStdString();
+        jsonDefaultValue[QStringLiteral("cType")] = value.cTypeName();
+        defaultValue["typesIndex"] = value.typesIndex().toStdString();
+        jsonDefaultValue[QStringLiteral("typesIndex")] = value.typesIndex();
+        defaultValue["initializer"] = value.cInitializer().toStdString();
+        jsonDefaultValue[QStringLiteral("initializer")] = value.cInitializer();
+        defaultValue["isArray"] = value.isArray();
+        jsonDefaultValue[QStringLiteral("isArray")] = value.isArray();
+        defaultValue["arraySize"] = std::to_string(value.size());
+        jsonDefaultValue[QStringLiteral("arraySize")] = double(value.size());
+
+        nodeMap["defaultValue"] = defaultValue;
+        jsonObj[QStringLiteral("defaultValue")] = jsonDefaultValue;
+    } else {
+        nodeMap["defaultValue"] = false;
+    }
 }
 
 void DeviceDriverCore::getMethodAsMustacheArray(
@@ -308,7 +401,7 @@ void DeviceDriverCore::getArgumentsAsMustacheArray(
     std::unordered_map<std::string, mustache::data>& argMap,
     QJsonObject& jsonArgMap)
 {
-    Argument arg = var->arguments().at(index);
+    const Argument& arg = var->arguments().at(index);
     std::string argumentNameValue = Utils::instance()->lowerFirstChar(arg.name).toStdString();
     argMap["argumentName"] = argumentNameValue.empty() ? mustache::data(false) : argumentNameValue;
     jsonArgMap[QStringLiteral("argumentName")] = QString::fromStdString(argumentNameValue);
@@ -403,7 +496,7 @@ std::unordered_map<std::string, mustache::data> DeviceDriverCore::createNodeMap(
     nodeMap["name"] = nameValue.empty() ? mustache::data(false) : nameValue;
     jsonNodeMap[QStringLiteral("name")] = QString::fromStdString(nameValue);
 
-    std::string nodeIdValue = item->nodeId().toStdString();
+    std::string nodeIdValue = Utils::toStdString(item->nodeIdUtf8());
     nodeMap["nodeId"] = nodeIdValue.empty() ? mustache::data(false) : nodeIdValue;
     jsonNodeMap[QStringLiteral("nodeId")] = QString::fromStdString(nodeIdValue);
 
@@ -427,11 +520,11 @@ std::unordered_map<std::string, mustache::data> DeviceDriverCore::createNodeMap(
                                                             : baseBrowseNameValue;
     jsonNodeMap[QStringLiteral("baseBrowseName")] = QString::fromStdString(baseBrowseNameValue);
 
-    std::string displayNameValue = item->displayName().toStdString();
+    std::string displayNameValue = Utils::toStdString(item->displayNameUtf8());
     nodeMap["displayName"] = displayNameValue.empty() ? mustache::data(false) : displayNameValue;
     jsonNodeMap[QStringLiteral("displayName")] = QString::fromStdString(displayNameValue);
 
-    std::string descriptionValue = item->description().toStdString();
+    std::string descriptionValue = Utils::toStdString(item->descriptionUtf8());
     nodeMap["description"] = descriptionValue.empty() ? mustache::data(false) : descriptionValue;
     jsonNodeMap[QStringLiteral("description")] = QString::fromStdString(descriptionValue);
 
@@ -545,7 +638,7 @@ DeviceDriverCore::getMustacheData()
         } else {
             std::string parentNodeIdStr = Utils::instance()
                                               ->sanitizeName(
-                                                  item->parentNode().lock()->nodeVariableName()
+                                                  item->parentItem()->nodeVariableName()
                                                   + QStringLiteral("_NodeId"))
                                               .toStdString();
             nodeMap["parentNodeId"] = parentNodeIdStr.empty() ? mustache::data(false)
@@ -555,7 +648,7 @@ DeviceDriverCore::getMustacheData()
             std::string referenceTypeNodeIdValue = "UA_NODEID_NUMERIC(0, "
                                                    + Utils::instance()
                                                          ->extractIdentifier(
-                                                             parentReferenceNodeId(item->getNode()))
+                                                             parentReferenceNodeId(item))
                                                          .toStdString()
                                                    + ")";
             nodeMap["referenceTypeNodeId"] = referenceTypeNodeIdValue.empty()
@@ -650,7 +743,9 @@ std::pair<mustache::data, QJsonDocument> DeviceDriverCore::getCMakeMustacheData(
             }
 
             for (auto& file : requiredFiles) {
-                file = file.section(QLatin1Char('/'), -1);
+                // the generated project uses the uncompressed files of its own UA-Nodeset
+                file = DecompressingDevice::withoutCompressionSuffix(
+                    file.section(QLatin1Char('/'), -1));
                 if (file.contains(QStringLiteral("NodeSet2.xml"))) {
                     std::string fileNsValue = file.toStdString();
                     nodeSetMap["file_ns"] = fileNsValue.empty() ? mustache::data(false)
@@ -909,188 +1004,40 @@ std::shared_ptr<UANode> DeviceDriverCore::findNodeById(
 void DeviceDriverCore::setNodeSetPath(const QString& newNodeSetPath)
 {
     m_nodeSetPath = newNodeSetPath;
+    m_catalog.setRootPath(m_nodeSetPath);
+    emit companionSpecsChanged();
 }
 
-void DeviceDriverCore::resolveParentNode()
-{
-    for (const std::shared_ptr<UANodeSet>& nodeSet : std::as_const(m_nodeSets)) {
-        auto nodes = nodeSet->nodes();
-        for (auto node : std::as_const(nodes)) {
-            QString parentNodeId = node->parentNodeId();
-            if (!parentNodeId.isEmpty()) {
-                auto parentNode = nodeSet->findNodeById(parentNodeId);
-                if (parentNode) {
-                    node->setParentNode(parentNode);
-                }
-            }
-        }
-    }
-}
-
-void DeviceDriverCore::resolveReferences()
+QString DeviceDriverCore::parentReferenceNodeId(TreeItem* item)
 {
-    // keep track of visited nodes to avoid cycles
-    QSet<std::shared_ptr<UANode>> visitedNodes;
-
-    for (const std::shared_ptr<UANodeSet>& nodeSet : std::as_const(m_nodeSets)) {
-        auto nodes = nodeSet->nodes();
-        for (const auto& node : std::as_const(nodes)) {
-            resolveNodeReferences(node, visitedNodes);
-        }
-    }
-}
-
-void DeviceDriverCore::resolveDataTypes()
-{
-    for (const std::shared_ptr<UANodeSet>& nodeSet : std::as_const(m_nodeSets)) {
-        QList<std::shared_ptr<UANode>> nodes = nodeSet->nodes();
-        for (const auto& node : std::as_const(nodes)) {
-            if (node->typeName() == XmlTags::UAVariable) {
-                std::shared_ptr<UAVariable> variable = std::dynamic_pointer_cast<UAVariable>(node);
-                QString dataTypeNode = nodeSet->getNodeIdByAlias(
-                    variable->dataType().definitionName());
-                if (dataTypeNode != QStringLiteral("")) {
-                    for (const std::shared_ptr<UANodeSet>& ns : std::as_const(m_nodeSets)) {
-                        auto node = ns->findNodeById(dataTypeNode);
-                        if (node && node->typeName() == XmlTags::UADataType) {
-                            std::shared_ptr<UADataType> dataType
-                                = std::dynamic_pointer_cast<UADataType>(node);
-                            if (dataType) {
-                                variable->setDataType(*dataType);
-                            }
-                        }
-                    }
-                }
-            }
-        }
-    }
-}
-
-void DeviceDriverCore::resolveMethods()
-{
-    for (const std::shared_ptr<UANodeSet>& nodeSet : std::as_const(m_nodeSets)) {
-        QList<std::shared_ptr<UANode>> nodes = nodeSet->nodes();
-        for (const std::shared_ptr<UANode>& node : std::as_const(nodes)) {
-            if (node->typeName() == XmlTags::UAMethod) {
-                std::shared_ptr<UAMethod> method = std::dynamic_pointer_cast<UAMethod>(node);
-                for (const std::shared_ptr<Reference>& reference : method->references()) {
-                    if (reference->node()) {
-                        if (reference->node()->browseName() == QStringLiteral("InputArguments")) {
-                            method->setInputArgument(
-                                std::dynamic_pointer_cast<UAVariable>(reference->node()));
-                        } else if (reference->node()->browseName() == QStringLiteral("OutputArguments")) {
-                            method->setOutputArgument(
-                                std::dynamic_pointer_cast<UAVariable>(reference->node()));
-                        }
-                    }
-                }
+    // The graph only knows the nodes of the nodesets, not the copies of edited items
+    const std::shared_ptr<UANode> node = item->sourceNode();
+    if (m_nodeGraph) {
+        const qint32 parentIndex = m_nodeGraph->indexOf(item->parentNode().lock().get());
+        const qint32 index = m_nodeGraph->indexOf(node.get());
+        for (const NodeGraph::Edge& edge : m_nodeGraph->edges(parentIndex)) {
+            if (edge.target != index)
+                continue;
+            QString refNodeId = m_nodeSets.value(m_selectedModelUri)
+                                    ->getNodeIdByAlias(edge.referenceType);
+            if (!refNodeId.isEmpty()) {
+                return refNodeId;
             }
         }
     }
-}
-
-QString DeviceDriverCore::parentReferenceNodeId(std::shared_ptr<UANode> node)
-{
-    {
-        for (const std::shared_ptr<Reference>& reference : node->parentNode().lock()->references()) {
-            if (reference->targetNodeId() == node->nodeId()) {
-                QString type = reference->referenceType();
-                QString refNodeId = m_nodeSets.value(m_selectedModelUri)->getNodeIdByAlias(type);
-                if (!refNodeId.isEmpty()) {
-                    return refNodeId;
-                }
-            }
-        }
 
-        qWarning() << "Access to non existing parentReferenceNodeId member from "
-                   << node->typeName();
-        return QStringLiteral("");
-    }
-}
-
-void DeviceDriverCore::resolveNodeReferences(
-    std::shared_ptr<UANode> node, QSet<std::shared_ptr<UANode>>& visitedNodes)
-{
-    if (visitedNodes.contains(node)) {
-        return;
-    }
-
-    visitedNodes.insert(node);
-
-    QList<std::shared_ptr<Reference>> references = node->references();
-    for (std::shared_ptr<Reference> reference : std::as_const(references)) {
-        std::shared_ptr<UANode> referencedNode
-            = findNodeById(reference->namespaceString(), reference->targetNodeId());
-        if (referencedNode) {
-            reference->setNode(referencedNode);
-
-            // set the optional flag for the node. This includes OptionalPlaceholders
-            if (reference->referenceType() == XmlTags::HasModellingRule) {
-                if (referencedNode->browseName().contains(XmlTags::Optional)) {
-                    node->setIsOptional(true);
-                }
-            }
-            // We want to get the inherited definition fields from the referenced node
-            if (reference->referenceType() == XmlTags::HasSubtype) {
-                if (std::shared_ptr<UADataType> dataTypeNode
-                    = std::dynamic_pointer_cast<UADataType>(node)) {
-                    if (const std::shared_ptr<UADataType> referenceDataType
-                        = std::dynamic_pointer_cast<UADataType>(reference->node())) {
-                        for (const auto [key, value] :
-                             referenceDataType->definitionFields().asKeyValueRange()) {
-                            dataTypeNode->addDefinitionField(key, value);
-                        }
-                    }
-                }
-            }
-
-            // Recursively resolve references for the referenced node
-            resolveNodeReferences(referencedNode, visitedNodes);
-        }
-    }
+    qWarning() << "Access to non existing parentReferenceNodeId member from " << node->typeName();
+    return QStringLiteral("");
 }
 
 QStringList DeviceDriverCore::findRequiredModels(const QString& fileName)
 {
     // finds the requiredModels (NodeSet2.xml files) from the selected Nodeset
-    QStringList requiredModels;
-    QFile file(fileName);
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        qWarning() << "Cannot open file for reading:" << file.errorString();
-        return requiredModels;
-    }
-
-    QXmlStreamReader xml(&file);
-    while (!xml.atEnd()) {
-        xml.readNext();
-        if (xml.isStartElement()) {
-            if (xml.name().toString() == XmlTags::Models) {
-                while (!xml.atEnd()) {
-                    xml.readNext();
-                    if (xml.isStartElement()) {
-                        if (xml.name().toString() == XmlTags::RequiredModel) {
-                            QXmlStreamAttributes attributes = xml.attributes();
-                            if (attributes.hasAttribute(XmlTags::ModelUri)) {
-                                QString modelUri = attributes.value(XmlTags::ModelUri).toString();
-                                requiredModels.append(modelUri);
-                            }
-                            // NOTE the Model is the URI of the selected Companion Specification.
-                        } else if (xml.name().toString() == XmlTags::Model) {
-                            QXmlStreamAttributes attributes = xml.attributes();
-                            if (attributes.hasAttribute(XmlTags::ModelUri)) {
-                                QString modelUri = attributes.value(XmlTags::ModelUri).toString();
-                                // Save the selected model to fill the model with the correct namespace
-                                m_selectedModelUri = modelUri;
-                                requiredModels.append(modelUri);
-                            }
-                        }
-                    }
-                }
-            }
-        }
-    }
-    file.close();
-    return requiredModels;
+    const UaNodeSetParser::ModelHeader header = UaNodeSetParser::readModelHeader(fileName);
+    // Save the selected model to fill the model with the correct namespace
+    if (!header.modelUri.isEmpty())
+        m_selectedModelUri = header.modelUri;
+    return header.modelUris;
 }
 
 QStringList DeviceDriverCore::findRequiredFiles(const QStringList& models, bool xmlOnly)
@@ -1098,65 +1045,47 @@ QStringList DeviceDriverCore::findRequiredFiles(const QStringList& models, bool
     // based on the requiredModels, find the corresponding NodeSet2.xml files
     QStringList requiredFiles;
     for (const QString& model : std::as_const(models)) {
-        QString folderName = QStringLiteral("/") + model.section(QChar::fromLatin1('/'), -2, -2);
-        // The UA NodeSet is always in the Schema folder
-        QString path = m_nodeSetPath
-                       + (folderName == QStringLiteral("/UA") ? QStringLiteral("/Schema")
-                                                              : folderName);
+        NodeSetCatalog::Entry entry = m_catalog.entryForModel(model);
+        if (!entry.isValid()) {
+            // Not in the catalog, fall back to the directory named after the model URI.
+            QString folderName = QStringLiteral("/")
+                                 + model.section(QChar::fromLatin1('/'), -2, -2);
+            // The UA NodeSet is always in the Schema folder
+            QString path = m_nodeSetPath
+                           + (folderName == QStringLiteral("/UA") ? QStringLiteral("/Schema")
+                                                                  : folderName);
+            entry = m_catalog.entryForDirectory(path);
+        }
         if (xmlOnly) {
-            requiredFiles.append(getNodeSetXmlFile(path));
+            requiredFiles.append(entry.nodeSetFile);
         } else {
-            requiredFiles.append((getAllNodesetFiles(path)));
+            requiredFiles.append(entry.files());
         }
     }
     return requiredFiles;
 }
 
-QStringList DeviceDriverCore::getAllNodesetFiles(const QString& dir)
+QString DeviceDriverCore::getNodeSetXmlFile(const QString& dir)
 {
-    qDebug() << "Getting all Nodeset files from directory:" << dir;
-
-    QStringList files;
-    QDir directory(dir);
-
-    if (!directory.exists()) {
-        qDebug() << "Directory does not exist!" << dir;
-    } else {
-        QFileInfoList fileInfoList = directory.entryInfoList(QDir::Files);
-        for (const QFileInfo& fileInfo : std::as_const(fileInfoList)) {
-            // We only want the NodeSet2.xml file
-            // TODO Sometimes there are multiple NodeSet2.xml files. Which one to choose? For now, just take the first one.
-            if (fileInfo.fileName().contains(QStringLiteral("NodeSet2.xml"))
-                || fileInfo.fileName().contains(QStringLiteral("NodeIds.csv"))
-                || fileInfo.fileName().contains(QStringLiteral("Types.bsd"))
-                       && !fileInfo.fileName().contains(QStringLiteral("Example"))) {
-                files.append(fileInfo.absoluteFilePath());
-            }
-        }
-    }
-
-    return files;
+    // TODO Sometimes there are multiple NodeSet2.xml files. Which one to choose? For now, just take the first one.
+    return m_catalog.entryForDirectory(dir).nodeSetFile;
 }
 
-QString DeviceDriverCore::getNodeSetXmlFile(const QString& dir)
+QVariantList DeviceDriverCore::companionSpecs() const
 {
-    qDebug() << "Getting NodeSet2.xml file from directory:" << dir;
-    QDir directory(dir);
-    if (!directory.exists()) {
-        qDebug() << "Directory does not exist!" << dir;
-    } else {
-        QFileInfoList fileInfoList = directory.entryInfoList(QDir::Files);
-
-        for (const QFileInfo& fileInfo : std::as_const(fileInfoList)) {
-            // We only want the NodeSet2.xml file
-            // TODO Sometimes there are multiple NodeSet2.xml files. Which one to choose? For now, just take the first one.
-            if (fileInfo.fileName().contains(QStringLiteral("NodeSet2.xml"))
-                && !fileInfo.fileName().contains(QStringLiteral("Example"))) {
-                return fileInfo.absoluteFilePath();
-            }
-        }
+    QVariantList specs;
+    const QList<NodeSetCatalog::Entry> entries = m_catalog.directoryEntries();
+    for (const NodeSetCatalog::Entry& entry : entries) {
+        QVariantMap spec;
+        spec[QStringLiteral("fileName")] = QFileInfo(entry.directory).fileName();
+        spec[QStringLiteral("filePath")] = entry.directory;
+        spec[QStringLiteral("modelUri")] = entry.modelUri;
+        spec[QStringLiteral("version")] = entry.version;
+        spec[QStringLiteral("publicationDate")] = entry.publicationDate;
+        spec[QStringLiteral("objectTypeCount")] = entry.objectTypeCount;
+        specs.append(spec);
     }
-    return QString();
+    return specs;
 }
 
 void DeviceDriverCore::loadState(const QString& filePath)
@@ -9,6 +9,8 @@
 
 #include "childitemfiltermodel.h"
 #include "mustache.hpp"
+#include "nodesetcatalog.h"
+#include "nodesetloader.h"
 #include "rootnodefiltermodel.h"
 #include "treemodel.h"
 #include "uanodesetparser.h"
@@ -44,12 +46,19 @@ class DeviceDriverCore : public QObject
                    existingFilePathChanged)
     Q_PROPERTY(QString outputFilePath READ outputFilePath WRITE setOutputFilePath NOTIFY
                    outputFilePathChanged)
+    Q_PROPERTY(QVariantList companionSpecs READ companionSpecs NOTIFY companionSpecsChanged)
+    Q_PROPERTY(qreal loadProgress READ loadProgress NOTIFY loadProgressChanged)
+    Q_PROPERTY(QString loadStatus READ loadStatus NOTIFY loadProgressChanged)
+    Q_PROPERTY(bool lazyLoadDependencies READ lazyLoadDependencies WRITE setLazyLoadDependencies
+                   NOTIFY lazyLoadDependenciesChanged)
 
 public:
     DeviceDriverCore();
     ~DeviceDriverCore();
 
+    // Loads asynchronously, setupFinished is emitted once the models are updated.
     Q_INVOKABLE void selectNodeSetXML(const QString& nodeSetDir);
+    Q_INVOKABLE void cancelLoading();
     Q_INVOKABLE void addRootNodeToSelectionModel(
         const QString& namespaceString, const QString& nodeId);
     Q_INVOKABLE void removeRootNodeFromSelection(const int index);
@@ -94,6 +103,17 @@ public:
     QString readMeMustacheTemplatePath() const;
     void setReadMeMustacheTemplatePath(const QString& newReadMeMustacheTemplatePath);
 
+    QVariantList companionSpecs() const;
+
+    // share of the NodeSet files of the current load that are parsed, by size
+    qreal loadProgress() const;
+    QString loadStatus() const;
+
+    // Only index the required models and parse their nodes when they are first referenced.
+    // Enabled by default, applies to the next selectNodeSetXML.
+    bool lazyLoadDependencies() const;
+    void setLazyLoadDependencies(bool lazyLoadDependencies);
+
 signals:
     void selectionModelChanged();
     void childItemFilterModelChanged();
@@ -106,14 +126,17 @@ signals:
     void existingFilePathChanged();
     void openProjectReturned(const bool& success);
     void generateCodeFinished();
+    void companionSpecsChanged();
+    void loadProgressChanged();
+    void lazyLoadDependenciesChanged();
 
 private:
     TreeModel* m_deviceTypesModel = nullptr;
     TreeModel* m_selectionModel = nullptr;
     ChildItemFilterModel* m_childItemFilterModel = nullptr;
 
-    UaNodeSetParser m_parser;
     QMap<QString, std::shared_ptr<UANodeSet>> m_nodeSets;
+    std::shared_ptr<NodeGraph> m_nodeGraph;
 
     QString m_nodeSetPath;
     QString m_mustacheTemplatePath;
@@ -125,22 +148,24 @@ private:
     QString m_selectedModelUri;
     QString m_currentNodeSetDir;
     QString m_projectName;
+    // Off by default: lazily loaded nodesets are neither snapshotted nor cached and are linked
+    // serially.
+    bool m_lazyLoadDependencies = false;
+    NodeSetCatalog m_catalog;
+    NodeSetLoader m_loader;
+    qreal m_loadProgress = 0.0;
+    QString m_loadStatus;
 
     QStringList findRequiredModels(const QString& fileName);
     QStringList findRequiredFiles(const QStringList& models, bool xmlOnly = true);
-    QStringList getAllNodesetFiles(const QString& dir);
     QString getNodeSetXmlFile(const QString& dir);
     QString ensureUniqueDirectory(const QString& path);
 
-    void parseNodeSets(const QString& nodeSetDir);
-    void resolveNodeReferences(
-        std::shared_ptr<UANode> node, QSet<std::shared_ptr<UANode>>& visitedNodes);
-    void resolveParentNode();
-    void resolveReferences();
-    void resolveDataTypes();
-    void resolveMethods();
+    NodeSetLoader::Request loadRequest(const QString& nodeSetDir);
+    void applyNodeSets(const NodeSetLoader::Result& result);
+    void setLoadProgress(qreal progress, const QString& status);
 
-    QString parentReferenceNodeId(std::shared_ptr<UANode> node);
+    QString parentReferenceNodeId(TreeItem* item);
 
     QList<TreeItem*> getSelectedItems();
     void travereseTreeModel(
@@ -0,0 +1,208 @@
+// SPDX-FileCopyrightText: 2025 Marius Dege <marius.dege@basyskom.com>
+// SPDX-FileCopyrightText: 2024 Marius Dege <marius.dege@basyskom.com>
+// SPDX-FileCopyrightText: 2024 basysKom GmbH
+
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "nodegraph.h"
+#include <QVarLengthArray>
+
+NodeGraph::NodeGraph(const QMap<QString, std::shared_ptr<UANodeSet>>& nodeSets)
+    : m_referenceTypes(nodeSets)
+{
+    // Lazy nodes that are still unloaded are not reachable from the resolved nodes.
+    for (const std::shared_ptr<UANodeSet>& nodeSet : nodeSets) {
+        const QList<std::shared_ptr<UANode>> nodes = nodeSet->loadedNodes();
+        for (const std::shared_ptr<UANode>& node : nodes) {
+            m_indices.insert(node.get(), m_nodes.size());
+            m_nodes.append(node);
+        }
+    }
+
+    m_rows.reserve(m_nodes.size() + 1);
+    for (const std::shared_ptr<UANode>& node : std::as_const(m_nodes)) {
+        appendRow(*node);
+    }
+}
+
+void NodeGraph::appendRow(const UANode& node)
+{
+    const Atom namespaceUri = node.namespaceAtom();
+    const QList<std::shared_ptr<Reference>>& references = node.references();
+    for (const Direction direction : {Direction::Forward, Direction::Inverse}) {
+        const bool isForward = direction == Direction::Forward;
+        QVarLengthArray<Atom, 8> referenceTypes;
+        for (const std::shared_ptr<Reference>& reference : references) {
+            if (reference->isForward() == isForward
+                && !referenceTypes.contains(reference->referenceTypeAtom()))
+                referenceTypes.append(reference->referenceTypeAtom());
+        }
+
+        for (const Atom referenceType : std::as_const(referenceTypes)) {
+            Segment segment{qint32(m_edges.size()), 0, referenceType, direction};
+            const ReferenceTypeLattice::Mask mask = m_referenceTypes.mask(
+                namespaceUri, referenceType);
+            for (const std::shared_ptr<Reference>& reference : references) {
+                if (reference->isForward() != isForward
+                    || reference->referenceTypeAtom() != referenceType)
+                    continue;
+                const std::shared_ptr<UANode> target = reference->node();
+                const qint32 targetIndex = indexOf(target.get());
+                if (targetIndex >= 0)
+                    m_edges.append({targetIndex, referenceType, mask});
+            }
+            segment.end = m_edges.size();
+            if (segment.end > segment.begin)
+                m_segments.append(segment);
+        }
+    }
+    m_rows.append(m_segments.size());
+}
+
+qint32 NodeGraph::indexOf(const UANode* node) const
+{
+    return m_indices.value(node, -1);
+}
+
+std::shared_ptr<UANode> NodeGraph::node(qint32 index) const
+{
+    return index >= 0 && index < m_nodes.size() ? m_nodes.at(index) : nullptr;
+}
+
+QSpan<const NodeGraph::Edge> NodeGraph::edges(qint32 node) const
+{
+    if (node < 0 || node >= m_nodes.size())
+        return {};
+    return segmentEdges(m_rows.at(node), m_rows.at(node + 1));
+}
+
+QSpan<const NodeGraph::Edge> NodeGraph::edges(qint32 node, Direction direction) const
+{
+    if (node < 0 || node >= m_nodes.size())
+        return {};
+    // the forward segments come first
+    qint32 first = m_rows.at(node);
+    qint32 last = m_rows.at(node + 1);
+    qint32 split = first;
+    while (split < last && m_segments.at(split).direction == Direction::Forward)
+        ++split;
+    if (direction == Direction::Forward)
+        last = split;
+    else
+        first = split;
+    return segmentEdges(first, last);
+}
+
+QSpan<const NodeGraph::Edge> NodeGraph::edges(
+    qint32 node, Atom referenceType, Direction direction) const
+{
+    if (node < 0 || node >= m_nodes.size())
+        return {};
+    // a node has only a few reference types
+    for (qint32 i = m_rows.at(node); i < m_rows.at(node + 1); ++i) {
+        const Segment& segment = m_segments.at(i);
+        if (segment.referenceType == referenceType && segment.direction == direction)
+            return segmentEdges(i, i + 1);
+    }
+    return {};
+}
+
+QSpan<const NodeGraph::Edge> NodeGraph::segmentEdges(qint32 first, qint32 last) const
+{
+    if (first >= last)
+        return {};
+    const qint32 begin = m_segments.at(first).begin;
+    const qint32 end = m_segments.at(last - 1).end;
+    return QSpan<const Edge>(m_edges.constData() + begin, end - begin);
+}
+
+QList<std::shared_ptr<UANode>> NodeGraph::inheritedNodes(const std::shared_ptr<UANode>& node)
+{
+    // The node itself is not memoised, it may be a copy that only lives in a selection.
+    QList<qint32> closure;
+    QSet<qint32> seen;
+    appendClosure(indexOf(node.get()), closure, seen);
+
+    QList<std::shared_ptr<UANode>> nodes;
+    nodes.reserve(closure.size());
+    for (const qint32 index : std::as_const(closure)) {
+        nodes.append(m_nodes.at(index));
+    }
+    return nodes;
+}
+
+QList<std::shared_ptr<UANode>> NodeGraph::inheritedMembers(const std::shared_ptr<UANode>& node)
+{
+    QList<qint32> closure;
+    QSet<qint32> seen;
+    appendClosure(indexOf(node.get()), closure, seen);
+
+    QList<std::shared_ptr<UANode>> members;
+    for (const qint32 index : std::as_const(closure)) {
+        members.append(entry(index).members);
+    }
+    return members;
+}
+
+bool NodeGraph::isInstanceDeclaration(const Edge& edge) const
+{
+    // HasModellingRule and the other non hierarchical references don't point to children
+    if (!edge.referenceTypes.intersects(
+            ReferenceTypeLattice::typeMask(ReferenceTypeLattice::HierarchicalReferences)))
+        return false;
+
+    const std::shared_ptr<UANode>& node = m_nodes.at(edge.target);
+    const QString& typeName = node->typeName();
+    if (typeName != XmlTags::UAObject && typeName != XmlTags::UAMethod
+        && typeName != XmlTags::UAVariable)
+        return false;
+
+    return !node->browseNameUtf8().contains("Arguments");
+}
+
+const NodeGraph::Entry& NodeGraph::entry(qint32 index)
+{
+    if (auto it = m_entries.constFind(index); it != m_entries.constEnd())
+        return *it;
+
+    // An empty entry first, a type on a reference cycle then sees its own closure as empty
+    // instead of recursing forever.
+    m_entries.insert(index, Entry());
+
+    Entry result;
+    QSet<qint32> seen;
+    appendClosure(index, result.closure, seen);
+    for (const Edge& edge : edges(index, Direction::Forward)) {
+        if (isInstanceDeclaration(edge))
+            result.members.append(m_nodes.at(edge.target));
+    }
+
+    Entry& stored = m_entries[index];
+    stored = std::move(result);
+    return stored;
+}
+
+void NodeGraph::appendClosure(qint32 index, QList<qint32>& closure, QSet<qint32>& seen)
+{
+    if (index < 0)
+        return;
+
+    constexpr ReferenceTypeLattice::Mask inheritance
+        = ReferenceTypeLattice::typeMask(ReferenceTypeLattice::HasSubtype)
+          | ReferenceTypeLattice::typeMask(ReferenceTypeLattice::HasTypeDefinition);
+    for (const Edge& edge : edges(index, Direction::Inverse)) {
+        if (!edge.referenceTypes.intersects(inheritance) || seen.contains(edge.target))
+            continue;
+        seen.insert(edge.target);
+        closure.append(edge.target);
+
+        // copied, entry() may rehash m_entries while the closure of the target is merged
+        const QList<qint32> targetClosure = entry(edge.target).closure;
+        for (const qint32 inheritedNode : targetClosure) {
+            if (!seen.contains(inheritedNode)) {
+                seen.insert(inheritedNode);
+                closure.append(inheritedNode);
+            }
+        }
+    }
+}
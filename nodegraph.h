@@ -0,0 +1,98 @@
+// SPDX-FileCopyrightText: 2025 Marius Dege <marius.dege@basyskom.com>
+// SPDX-FileCopyrightText: 2024 Marius Dege <marius.dege@basyskom.com>
+// SPDX-FileCopyrightText: 2024 basysKom GmbH
+
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#ifndef NODEGRAPH_H
+#define NODEGRAPH_H
+
+#include "referencetypelattice.h"
+#include "uanode.h"
+#include <QHash>
+#include <QList>
+#include <QMap>
+#include <QSet>
+#include <QSpan>
+
+// Reference graph and type hierarchy queries on the resolved nodesets. The references of every
+// node are stored in compressed sparse row form: one contiguous row per node, forward references
+// first, each direction grouped by reference type in the order the types first appear. A
+// reference type of a node is then a range of the row and is read without allocating. Every
+// edge carries the ReferenceTypeLattice mask of its reference type, so tests like "is
+// hierarchical" are a single AND.
+//
+// The hierarchy results are memoised per type node, so supertypes shared by many types, like
+// BaseObjectType or DeviceType, are only walked once. Has to be replaced when the nodesets change.
+class NodeGraph
+{
+public:
+    enum class Direction : quint8 { Forward, Inverse };
+
+    struct Edge
+    {
+        qint32 target;
+        Atom referenceType;
+        // the reference type and its supertypes
+        ReferenceTypeLattice::Mask referenceTypes;
+    };
+
+    NodeGraph() = default;
+    // Indexes the loaded nodes, references to nodes outside the nodesets are left out.
+    explicit NodeGraph(const QMap<QString, std::shared_ptr<UANodeSet>>& nodeSets);
+
+    // Index of the node, -1 if it is not in the graph. Copies of a node, like the ones of edited
+    // tree items, are not in the graph.
+    qint32 indexOf(const UANode* node) const;
+    std::shared_ptr<UANode> node(qint32 index) const;
+
+    // All references of the node
+    QSpan<const Edge> edges(qint32 node) const;
+    QSpan<const Edge> edges(qint32 node, Direction direction) const;
+    QSpan<const Edge> edges(qint32 node, Atom referenceType, Direction direction) const;
+
+    // Supertypes and type definitions of the node, reached over inverse HasSubtype and
+    // HasTypeDefinition references, each once and in the order they are first reached.
+    QList<std::shared_ptr<UANode>> inheritedNodes(const std::shared_ptr<UANode>& node);
+    // Instance declarations of all inherited nodes, the children a type gets from its supertypes
+    QList<std::shared_ptr<UANode>> inheritedMembers(const std::shared_ptr<UANode>& node);
+
+    // Objects, variables and methods below the node over a forward hierarchical reference,
+    // except argument lists
+    bool isInstanceDeclaration(const Edge& edge) const;
+
+private:
+    // edges of one reference type and direction, a range of m_edges
+    struct Segment
+    {
+        qint32 begin;
+        qint32 end;
+        Atom referenceType;
+        Direction direction;
+    };
+
+    struct Entry
+    {
+        QList<qint32> closure;
+        QList<std::shared_ptr<UANode>> members;
+    };
+
+    ReferenceTypeLattice m_referenceTypes;
+    QList<std::shared_ptr<UANode>> m_nodes;
+    // The index of every node of m_nodes. Kept per graph, since the nodes of cached nodesets are
+    // shared by the graphs of several loads.
+    QHash<const UANode*, qint32> m_indices;
+    // the segments of node i are m_segments[m_rows[i]] to m_segments[m_rows[i + 1]]
+    QList<qint32> m_rows{0};
+    QList<Segment> m_segments;
+    QList<Edge> m_edges;
+
+    QHash<qint32, Entry> m_entries;
+
+    void appendRow(const UANode& node);
+    QSpan<const Edge> segmentEdges(qint32 first, qint32 last) const;
+    const Entry& entry(qint32 index);
+    void appendClosure(qint32 index, QList<qint32>& closure, QSet<qint32>& seen);
+};
+
+#endif // NODEGRAPH_H
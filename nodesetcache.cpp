@@ -0,0 +1,136 @@
+// SPDX-FileCopyrightText: 2025 Marius Dege <marius.dege@basyskom.com>
+// SPDX-FileCopyrightText: 2024 Marius Dege <marius.dege@basyskom.com>
+// SPDX-FileCopyrightText: 2024 basysKom GmbH
+
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "nodesetcache.h"
+#include <algorithm>
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+
+NodeSetCache* NodeSetCache::instance()
+{
+    // never destroyed, like the atom table the cached nodesets depend on
+    static NodeSetCache* cache = new NodeSetCache();
+    return cache;
+}
+
+QByteArray NodeSetCache::fileHash(const QString& filePath)
+{
+    struct CachedHash
+    {
+        QDateTime lastModified;
+        qint64 size = -1;
+        QByteArray hash;
+    };
+    static QMutex cacheMutex;
+    static QHash<QString, CachedHash> cache;
+
+    const QFileInfo fileInfo(filePath);
+    const QDateTime lastModified = fileInfo.lastModified();
+    const qint64 size = fileInfo.size();
+    {
+        QMutexLocker locker(&cacheMutex);
+        const auto it = cache.constFind(filePath);
+        if (it != cache.constEnd() && it->lastModified == lastModified && it->size == size)
+            return it->hash;
+    }
+
+    // MD5 is only used to detect changed files, not for security.
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QByteArray();
+    }
+    QCryptographicHash hash(QCryptographicHash::Md5);
+    hash.addData(&file);
+    const QByteArray result = hash.result();
+
+    QMutexLocker locker(&cacheMutex);
+    cache.insert(filePath, {lastModified, size, result});
+    return result;
+}
+
+QMap<QString, std::shared_ptr<UANodeSet>> NodeSetCache::find(
+    const QMap<QString, QByteArray>& fileHashes)
+{
+    QMutexLocker locker(&m_mutex);
+
+    QMap<QString, std::shared_ptr<UANodeSet>> nodeSets;
+    QMap<QString, QMap<QString, QByteArray>> dependencies;
+    for (const auto [modelUri, hash] : fileHashes.asKeyValueRange()) {
+        const auto entry = m_entries.constFind(modelUri);
+        if (entry == m_entries.constEnd() || hash.isEmpty() || entry->fileHash != hash)
+            continue;
+        std::shared_ptr<UANodeSet> nodeSet = entry->nodeSet.lock();
+        if (!nodeSet)
+            continue;
+
+        // The references of the nodeset point into the models it was resolved against. They must
+        // be the same now, and a model that was missing then would stay unresolved.
+        bool sameDependencies = true;
+        const QMap<int, QString> namespaceMap = nodeSet->namespaceMap();
+        for (const QString& namespaceUri : namespaceMap) {
+            if (namespaceUri == modelUri)
+                continue;
+            if (fileHashes.value(namespaceUri) != entry->dependencies.value(namespaceUri)) {
+                sameDependencies = false;
+                break;
+            }
+        }
+        if (sameDependencies) {
+            nodeSets.insert(modelUri, nodeSet);
+            dependencies.insert(modelUri, entry->dependencies);
+        }
+    }
+
+    // Drop every nodeset whose dependencies are not reused as well, until nothing changes.
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (auto it = nodeSets.begin(); it != nodeSets.end();) {
+            const QList<QString> dependencyUris = dependencies.value(it.key()).keys();
+            const bool complete = std::all_of(
+                dependencyUris.cbegin(), dependencyUris.cend(), [&nodeSets](const QString& uri) {
+                    return nodeSets.contains(uri);
+                });
+            if (complete) {
+                ++it;
+            } else {
+                it = nodeSets.erase(it);
+                changed = true;
+            }
+        }
+    }
+    return nodeSets;
+}
+
+void NodeSetCache::insert(
+    const QMap<QString, std::shared_ptr<UANodeSet>>& nodeSets,
+    const QMap<QString, QByteArray>& fileHashes)
+{
+    QMutexLocker locker(&m_mutex);
+
+    for (const auto [modelUri, nodeSet] : nodeSets.asKeyValueRange()) {
+        const QByteArray hash = fileHashes.value(modelUri);
+        // lazy nodesets still change when their nodes are loaded
+        if (!nodeSet || nodeSet->isLazy() || hash.isEmpty())
+            continue;
+
+        Entry entry{hash, nodeSet, {}};
+        const QMap<int, QString> namespaceMap = nodeSet->namespaceMap();
+        for (const QString& namespaceUri : namespaceMap) {
+            if (namespaceUri != modelUri && fileHashes.contains(namespaceUri))
+                entry.dependencies.insert(namespaceUri, fileHashes.value(namespaceUri));
+        }
+        m_entries.insert(modelUri, entry);
+    }
+
+    // forget the nodesets nobody uses anymore
+    m_entries.removeIf([](const QHash<QString, Entry>::iterator entry) {
+        return entry->nodeSet.expired();
+    });
+}
@@ -0,0 +1,56 @@
+// SPDX-FileCopyrightText: 2025 Marius Dege <marius.dege@basyskom.com>
+// SPDX-FileCopyrightText: 2024 Marius Dege <marius.dege@basyskom.com>
+// SPDX-FileCopyrightText: 2024 basysKom GmbH
+
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#ifndef NODESETCACHE_H
+#define NODESETCACHE_H
+
+#include "uanodeset.h"
+#include <QByteArray>
+#include <QHash>
+#include <QMap>
+#include <QMutex>
+#include <QString>
+
+// Process wide cache of parsed and resolved nodesets, keyed by model URI and the hash of the
+// NodeSet2.xml file. Every companion spec requires the UA core nodeset and most of them DI, so
+// switching specs only has to parse the models that are not in use already.
+//
+// A cached nodeset is shared with every load that reuses it and must not be changed anymore. The
+// cache only holds weak pointers, a nodeset stays available as long as some load result uses it.
+class NodeSetCache
+{
+public:
+    static NodeSetCache* instance();
+
+    // MD5 of the file contents, empty if the file can't be read. The hash is cached per file
+    // until its size or modification time changes. Thread safe.
+    static QByteArray fileHash(const QString& filePath);
+
+    // Returns the cached nodesets of the requested models that can be reused, keyed by model URI.
+    // A nodeset is only reused together with the nodesets it was resolved against, and only if
+    // the request contains no other version of a model it references.
+    QMap<QString, std::shared_ptr<UANodeSet>> find(const QMap<QString, QByteArray>& fileHashes);
+    // Adds the resolved nodesets of a load, hashes are keyed by model URI like the nodesets.
+    void insert(
+        const QMap<QString, std::shared_ptr<UANodeSet>>& nodeSets,
+        const QMap<QString, QByteArray>& fileHashes);
+
+private:
+    NodeSetCache() = default;
+
+    struct Entry
+    {
+        QByteArray fileHash;
+        std::weak_ptr<UANodeSet> nodeSet;
+        // file hashes of the referenced models the nodeset was resolved against
+        QMap<QString, QByteArray> dependencies;
+    };
+
+    QMutex m_mutex;
+    QHash<QString, Entry> m_entries;
+};
+
+#endif // NODESETCACHE_H
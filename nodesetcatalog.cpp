@@ -0,0 +1,379 @@
+// SPDX-FileCopyrightText: 2025 Marius Dege <marius.dege@basyskom.com>
+// SPDX-FileCopyrightText: 2024 Marius Dege <marius.dege@basyskom.com>
+// SPDX-FileCopyrightText: 2024 basysKom GmbH
+
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "nodesetcatalog.h"
+#include "Util/DecompressingDevice.h"
+#include "uanodesetparser.h"
+#include <QByteArrayMatcher>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <algorithm>
+
+namespace {
+
+constexpr int CatalogFormatVersion = 3;
+
+QString normalizedPath(const QString& path)
+{
+    return QDir::cleanPath(QFileInfo(path).absoluteFilePath());
+}
+
+qint64 modificationTime(const QFileInfo& fileInfo)
+{
+    return fileInfo.lastModified().toMSecsSinceEpoch();
+}
+
+bool isSpecFile(const QString& fileName, const QString& suffix)
+{
+    return DecompressingDevice::withoutCompressionSuffix(fileName).contains(suffix)
+           && !fileName.contains(QStringLiteral("Example"));
+}
+
+// Compressed files are used if this build can read them and there is no uncompressed copy.
+bool isReadable(const QFileInfo& fileInfo)
+{
+    const DecompressingDevice::Compression compression = DecompressingDevice::compression(
+        fileInfo.fileName());
+    if (compression == DecompressingDevice::Compression::None)
+        return true;
+    return DecompressingDevice::isSupported(compression)
+           && !QFileInfo::exists(
+               DecompressingDevice::withoutCompressionSuffix(fileInfo.absoluteFilePath()));
+}
+
+// Prefer the file with the same prefix as the NodeSet2.xml, e.g. Opc.Ua.Di.NodeIds.csv for
+// Opc.Ua.Di.NodeSet2.xml, otherwise take the first one.
+QString companionFile(const QStringList& candidates, const QString& prefix)
+{
+    for (const QString& candidate : candidates) {
+        if (QFileInfo(candidate).fileName().startsWith(prefix))
+            return candidate;
+    }
+    return candidates.value(0);
+}
+
+int countObjectTypes(const QString& filePath)
+{
+    // the closing tags start with "</" and don't match
+    const QByteArrayMatcher matcher(QByteArrayView("<UAObjectType"));
+    const auto count = [&matcher](QByteArrayView data) {
+        int count = 0;
+        qsizetype pos = 0;
+        while ((pos = matcher.indexIn(data, pos)) >= 0) {
+            ++count;
+            pos += matcher.pattern().size();
+        }
+        return count;
+    };
+
+    if (DecompressingDevice::compression(filePath) != DecompressingDevice::Compression::None) {
+        DecompressingDevice device(filePath);
+        if (!device.open(QIODevice::ReadOnly))
+            return 0;
+        // Keep the end of the previous chunk, a tag may be split across two chunks.
+        const qsizetype overlap = matcher.pattern().size() - 1;
+        int result = 0;
+        QByteArray buffer;
+        while (!device.atEnd()) {
+            const QByteArray chunk = device.read(256 * 1024);
+            if (chunk.isEmpty())
+                break;
+            buffer.append(chunk);
+            result += count(buffer);
+            buffer = buffer.right(overlap);
+        }
+        return result;
+    }
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly))
+        return 0;
+
+    QByteArray content;
+    QByteArrayView data;
+    uchar* mapped = file.size() > 0 ? file.map(0, file.size()) : nullptr;
+    if (mapped) {
+        data = QByteArrayView(reinterpret_cast<const char*>(mapped), file.size());
+    } else {
+        content = file.readAll();
+        data = content;
+    }
+
+    const int result = count(data);
+
+    if (mapped)
+        file.unmap(mapped);
+    return result;
+}
+
+QJsonObject toJson(const NodeSetCatalog::Entry& entry)
+{
+    QJsonObject object;
+    object[QStringLiteral("modelUri")] = entry.modelUri;
+    object[QStringLiteral("nodeSetFile")] = entry.nodeSetFile;
+    object[QStringLiteral("nodeIdsFile")] = entry.nodeIdsFile;
+    object[QStringLiteral("typesFile")] = entry.typesFile;
+    object[QStringLiteral("version")] = entry.version;
+    object[QStringLiteral("publicationDate")] = entry.publicationDate;
+    object[QStringLiteral("objectTypeCount")] = entry.objectTypeCount;
+    object[QStringLiteral("lastModified")] = static_cast<double>(entry.lastModified);
+    object[QStringLiteral("size")] = static_cast<double>(entry.size);
+    return object;
+}
+
+NodeSetCatalog::Entry entryFromJson(const QJsonObject& object, const QString& directory)
+{
+    NodeSetCatalog::Entry entry;
+    entry.modelUri = object.value(QStringLiteral("modelUri")).toString();
+    entry.directory = directory;
+    entry.nodeSetFile = object.value(QStringLiteral("nodeSetFile")).toString();
+    entry.nodeIdsFile = object.value(QStringLiteral("nodeIdsFile")).toString();
+    entry.typesFile = object.value(QStringLiteral("typesFile")).toString();
+    entry.version = object.value(QStringLiteral("version")).toString();
+    entry.publicationDate = object.value(QStringLiteral("publicationDate")).toString();
+    entry.objectTypeCount = object.value(QStringLiteral("objectTypeCount")).toInt();
+    entry.lastModified = static_cast<qint64>(
+        object.value(QStringLiteral("lastModified")).toDouble());
+    entry.size = static_cast<qint64>(object.value(QStringLiteral("size")).toDouble(-1));
+    return entry;
+}
+
+} // namespace
+
+QStringList NodeSetCatalog::Entry::files() const
+{
+    QStringList result;
+    for (const QString& file : {nodeSetFile, nodeIdsFile, typesFile}) {
+        if (!file.isEmpty())
+            result.append(file);
+    }
+    return result;
+}
+
+NodeSetCatalog::NodeSetCatalog() {}
+
+QString NodeSetCatalog::rootPath() const
+{
+    return m_rootPath;
+}
+
+void NodeSetCatalog::setRootPath(const QString& rootPath)
+{
+    const QString path = normalizedPath(rootPath);
+    if (m_rootPath == path)
+        return;
+
+    m_rootPath = path;
+    m_directories.clear();
+    load();
+    refresh();
+}
+
+void NodeSetCatalog::refresh()
+{
+    if (m_rootPath.isEmpty())
+        return;
+
+    const QFileInfoList directoryInfos = QDir(m_rootPath).entryInfoList(
+        QDir::Dirs | QDir::NoDotAndDotDot);
+
+    QMap<QString, Directory> directories;
+    bool changed = directoryInfos.size() != m_directories.size();
+    for (const QFileInfo& directoryInfo : directoryInfos) {
+        const QString path = normalizedPath(directoryInfo.absoluteFilePath());
+        const qint64 lastModified = modificationTime(directoryInfo);
+        const auto it = m_directories.constFind(path);
+        if (it != m_directories.constEnd() && isUpToDate(*it, lastModified)) {
+            directories.insert(path, it.value());
+        } else {
+            directories.insert(path, scanDirectory(path, lastModified));
+            changed = true;
+        }
+    }
+
+    m_directories = directories;
+    rebuildModelIndex();
+    if (changed)
+        save();
+}
+
+NodeSetCatalog::Entry NodeSetCatalog::entryForModel(const QString& modelUri) const
+{
+    return m_entriesByModelUri.value(modelUri);
+}
+
+NodeSetCatalog::Entry NodeSetCatalog::entryForDirectory(const QString& directory)
+{
+    const QString path = normalizedPath(directory);
+    const qint64 lastModified = modificationTime(QFileInfo(path));
+    auto it = m_directories.find(path);
+    if (it == m_directories.end() || !isUpToDate(*it, lastModified)) {
+        it = m_directories.insert(path, scanDirectory(path, lastModified));
+        rebuildModelIndex();
+    }
+    return it->entries.value(0);
+}
+
+QList<NodeSetCatalog::Entry> NodeSetCatalog::directoryEntries() const
+{
+    QList<Entry> entries;
+    for (const Directory& directory : m_directories) {
+        if (!directory.entries.isEmpty())
+            entries.append(directory.entries.first());
+    }
+    std::sort(entries.begin(), entries.end(), [](const Entry& left, const Entry& right) {
+        return QFileInfo(left.directory).fileName().compare(
+                   QFileInfo(right.directory).fileName(), Qt::CaseInsensitive)
+               < 0;
+    });
+    return entries;
+}
+
+bool NodeSetCatalog::isUpToDate(const Directory& directory, qint64 lastModified)
+{
+    if (directory.lastModified != lastModified)
+        return false;
+    // Overwriting a file in place doesn't change the modification time of its directory
+    return std::all_of(
+        directory.entries.cbegin(), directory.entries.cend(), [](const Entry& entry) {
+            const QFileInfo fileInfo(entry.nodeSetFile);
+            return modificationTime(fileInfo) == entry.lastModified
+                   && fileInfo.size() == entry.size;
+        });
+}
+
+NodeSetCatalog::Directory NodeSetCatalog::scanDirectory(
+    const QString& directory, qint64 lastModified) const
+{
+    qDebug() << "Scanning NodeSet directory:" << directory;
+
+    Directory result;
+    result.lastModified = lastModified;
+
+    QStringList nodeSetFiles;
+    QStringList nodeIdsFiles;
+    QStringList typesFiles;
+    const QFileInfoList fileInfos = QDir(directory).entryInfoList(QDir::Files);
+    for (const QFileInfo& fileInfo : fileInfos) {
+        const QString fileName = fileInfo.fileName();
+        if (!isReadable(fileInfo))
+            continue;
+        if (isSpecFile(fileName, QStringLiteral("NodeSet2.xml"))) {
+            nodeSetFiles.append(fileInfo.absoluteFilePath());
+        } else if (isSpecFile(fileName, QStringLiteral("NodeIds.csv"))) {
+            nodeIdsFiles.append(fileInfo.absoluteFilePath());
+        } else if (isSpecFile(fileName, QStringLiteral("Types.bsd"))) {
+            typesFiles.append(fileInfo.absoluteFilePath());
+        }
+    }
+
+    for (const QString& nodeSetFile : std::as_const(nodeSetFiles)) {
+        // taken before reading, a file that changes meanwhile is scanned again next time
+        const QFileInfo fileInfo(nodeSetFile);
+        const UaNodeSetParser::ModelHeader header = UaNodeSetParser::readModelHeader(nodeSetFile);
+        const QString fileName = DecompressingDevice::withoutCompressionSuffix(
+            QFileInfo(nodeSetFile).fileName());
+        const QString prefix = fileName.left(fileName.indexOf(QStringLiteral("NodeSet2.xml")));
+
+        Entry entry;
+        entry.modelUri = header.modelUri;
+        entry.directory = directory;
+        entry.nodeSetFile = nodeSetFile;
+        entry.nodeIdsFile = companionFile(nodeIdsFiles, prefix);
+        entry.typesFile = companionFile(typesFiles, prefix);
+        entry.version = header.version;
+        entry.publicationDate = header.publicationDate;
+        entry.objectTypeCount = countObjectTypes(nodeSetFile);
+        entry.lastModified = modificationTime(fileInfo);
+        entry.size = fileInfo.size();
+        result.entries.append(entry);
+    }
+
+    return result;
+}
+
+void NodeSetCatalog::rebuildModelIndex()
+{
+    m_entriesByModelUri.clear();
+    for (const Directory& directory : std::as_const(m_directories)) {
+        for (const Entry& entry : directory.entries) {
+            // the first directory providing a model wins
+            if (!entry.modelUri.isEmpty() && !m_entriesByModelUri.contains(entry.modelUri))
+                m_entriesByModelUri.insert(entry.modelUri, entry);
+        }
+    }
+}
+
+QString NodeSetCatalog::catalogFilePath() const
+{
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation)
+           + QStringLiteral("/nodeset-catalog.json");
+}
+
+void NodeSetCatalog::load()
+{
+    QFile file(catalogFilePath());
+    if (!file.open(QIODevice::ReadOnly))
+        return;
+
+    const QJsonObject catalog = QJsonDocument::fromJson(file.readAll()).object();
+    if (catalog.value(QStringLiteral("formatVersion")).toInt() != CatalogFormatVersion
+        || catalog.value(QStringLiteral("rootPath")).toString() != m_rootPath) {
+        return;
+    }
+
+    const QJsonArray directories = catalog.value(QStringLiteral("directories")).toArray();
+    for (const QJsonValue& value : directories) {
+        const QJsonObject object = value.toObject();
+        const QString path = object.value(QStringLiteral("path")).toString();
+
+        Directory directory;
+        directory.lastModified = static_cast<qint64>(
+            object.value(QStringLiteral("lastModified")).toDouble());
+        const QJsonArray nodeSets = object.value(QStringLiteral("nodeSets")).toArray();
+        for (const QJsonValue& nodeSet : nodeSets) {
+            directory.entries.append(entryFromJson(nodeSet.toObject(), path));
+        }
+        m_directories.insert(path, directory);
+    }
+}
+
+void NodeSetCatalog::save() const
+{
+    QJsonArray directories;
+    for (auto it = m_directories.constBegin(); it != m_directories.constEnd(); ++it) {
+        QJsonArray nodeSets;
+        for (const Entry& entry : it->entries) {
+            nodeSets.append(toJson(entry));
+        }
+        QJsonObject directory;
+        directory[QStringLiteral("path")] = it.key();
+        directory[QStringLiteral("lastModified")] = static_cast<double>(it->lastModified);
+        directory[QStringLiteral("nodeSets")] = nodeSets;
+        directories.append(directory);
+    }
+
+    QJsonObject catalog;
+    catalog[QStringLiteral("formatVersion")] = CatalogFormatVersion;
+    catalog[QStringLiteral("rootPath")] = m_rootPath;
+    catalog[QStringLiteral("directories")] = directories;
+
+    QDir().mkpath(QFileInfo(catalogFilePath()).absolutePath());
+    QSaveFile file(catalogFilePath());
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Could not write NodeSet catalog:" << file.errorString();
+        return;
+    }
+    file.write(QJsonDocument(catalog).toJson(QJsonDocument::Compact));
+    file.commit();
+}
@@ -0,0 +1,76 @@
+// SPDX-FileCopyrightText: 2025 Marius Dege <marius.dege@basyskom.com>
+// SPDX-FileCopyrightText: 2024 Marius Dege <marius.dege@basyskom.com>
+// SPDX-FileCopyrightText: 2024 basysKom GmbH
+
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#ifndef NODESETCATALOG_H
+#define NODESETCATALOG_H
+
+#include <QHash>
+#include <QList>
+#include <QMap>
+#include <QString>
+#include <QStringList>
+
+// Index of the NodeSet2.xml files in the UA-Nodeset checkout. Every spec directory is scanned once,
+// the result is persisted in the cache directory and a directory is only scanned again when its
+// modification time or the modification time or size of one of its NodeSet2.xml files changes.
+class NodeSetCatalog
+{
+public:
+    struct Entry
+    {
+        QString modelUri;
+        QString directory;
+        QString nodeSetFile;
+        QString nodeIdsFile;
+        QString typesFile;
+        QString version;
+        QString publicationDate;
+        int objectTypeCount = 0;
+        // of the nodeSetFile when it was indexed
+        qint64 lastModified = 0;
+        qint64 size = -1;
+
+        bool isValid() const { return !nodeSetFile.isEmpty(); }
+        // NodeSet2.xml, NodeIds.csv and Types.bsd, if present
+        QStringList files() const;
+    };
+
+    NodeSetCatalog();
+
+    QString rootPath() const;
+    void setRootPath(const QString& rootPath);
+
+    // Picks up spec directories that were added, removed or changed since the last refresh.
+    void refresh();
+
+    Entry entryForModel(const QString& modelUri) const;
+    // The first NodeSet2.xml of a directory. Directories outside of the root are scanned on demand.
+    Entry entryForDirectory(const QString& directory);
+    // One entry per spec directory, sorted by directory name
+    QList<Entry> directoryEntries() const;
+
+private:
+    struct Directory
+    {
+        qint64 lastModified = 0;
+        QList<Entry> entries;
+    };
+
+    QString m_rootPath;
+    // spec directory -> NodeSet2.xml files found in it
+    QMap<QString, Directory> m_directories;
+    QHash<QString, Entry> m_entriesByModelUri;
+
+    Directory scanDirectory(const QString& directory, qint64 lastModified) const;
+    static bool isUpToDate(const Directory& directory, qint64 lastModified);
+    void rebuildModelIndex();
+
+    QString catalogFilePath() const;
+    void load();
+    void save() const;
+};
+
+#endif // NODESETCATALOG_H
@@ -0,0 +1,198 @@
+// SPDX-FileCopyrightText: 2025 Marius Dege <marius.dege@basyskom.com>
+// SPDX-FileCopyrightText: 2024 Marius Dege <marius.dege@basyskom.com>
+// SPDX-FileCopyrightText: 2024 basysKom GmbH
+
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "nodesetloader.h"
+#include "Util/Utils.h"
+#include "nodesetcache.h"
+#include "nodesetresolver.h"
+#include "nodesetsnapshot.h"
+#include "uanodesetparser.h"
+#include <atomic>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QSet>
+#include <QtConcurrent/QtConcurrentMap>
+#include <QtConcurrent/QtConcurrentRun>
+
+NodeSetLoader::NodeSetLoader(QObject* parent)
+    : QObject(parent)
+{
+    m_pool.setMaxThreadCount(1);
+
+    connect(&m_watcher, &QFutureWatcher<Result>::finished, this, [this]() {
+        const QFuture<Result> future = m_watcher.future();
+        if (future.isCanceled() || future.resultCount() == 0)
+            return;
+        emit finished(future.result());
+    });
+}
+
+NodeSetLoader::~NodeSetLoader()
+{
+    // the worker emits signals of this object
+    cancel();
+    m_pool.waitForDone();
+}
+
+void NodeSetLoader::load(const Request& request)
+{
+    cancel();
+    // Utils is created lazily and used while parsing, so create it before the workers start.
+    Utils::instance();
+
+    const quint64 generation = m_generation;
+    m_bytesLoaded = 0;
+    m_nodesLoaded = 0;
+    m_watcher.setFuture(
+        QtConcurrent::run(&m_pool, [this, request, generation](QPromise<Result>& promise) {
+            run(promise, request, generation);
+        }));
+}
+
+void NodeSetLoader::cancel()
+{
+    // reports of the previous load that are still queued are dropped
+    ++m_generation;
+    m_watcher.cancel();
+}
+
+void NodeSetLoader::reportFile(
+    quint64 generation, const QString& filePath, qint64 bytes, qint64 nodes, qint64 bytesTotal)
+{
+    if (generation != m_generation)
+        return;
+    // the workers finish in any order, the totals are summed up here so they only grow
+    m_bytesLoaded += bytes;
+    m_nodesLoaded += nodes;
+    emit fileLoaded(filePath, bytes, nodes);
+    emit progressChanged(m_bytesLoaded, bytesTotal, m_nodesLoaded);
+}
+
+bool NodeSetLoader::isLoading() const
+{
+    return m_watcher.isRunning();
+}
+
+void NodeSetLoader::run(QPromise<Result>& promise, const Request& request, quint64 generation)
+{
+    qDebug() << "Loading NodeSets for" << request.selectedModelUri;
+    Result result;
+    result.selectedModelUri = request.selectedModelUri;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    // Nodesets that are still in use by a previous load are reused as they are. Lazy nodesets
+    // change while they are used, so they are neither taken from nor put into the cache.
+    const bool lazy = request.lazyLoadDependencies;
+    QMap<QString, QByteArray> fileHashes;
+    QList<QByteArray> hashesInFileOrder;
+    QMap<QString, std::shared_ptr<UANodeSet>> cachedNodeSets;
+    if (!lazy) {
+        for (int i = 0; i < request.modelUris.size(); i++) {
+            hashesInFileOrder.append(NodeSetCache::fileHash(request.files.at(i)));
+            fileHashes.insert(request.modelUris.at(i), hashesInFileOrder.last());
+        }
+        cachedNodeSets = NodeSetCache::instance()->find(fileHashes);
+        if (cachedNodeSets.size() == request.modelUris.size()) {
+            result.nodeSets = cachedNodeSets;
+            qDebug() << "Reused" << cachedNodeSets.size() << "cached NodeSets in" << timer.elapsed()
+                     << "ms";
+            promise.addResult(std::move(result));
+            return;
+        }
+    }
+
+#ifndef WASM_BUILD
+    // The snapshot holds the already resolved nodesets, so a hit skips parsing and resolving.
+    // A snapshot always contains every node, which would defeat lazy loading. Loading it would
+    // replace the nodesets that can be shared with the cache, so it is only used without them.
+    const QString snapshotKey = lazy
+                                    ? QString()
+                                    : NodeSetSnapshot::cacheKey(request.files, hashesInFileOrder);
+    if (!snapshotKey.isEmpty() && cachedNodeSets.isEmpty()
+        && NodeSetSnapshot::load(snapshotKey, result.nodeSets)) {
+        qDebug() << "Loaded" << result.nodeSets.size() << "NodeSets from snapshot in"
+                 << timer.elapsed() << "ms";
+        NodeSetCache::instance()->insert(result.nodeSets, fileHashes);
+        promise.addResult(std::move(result));
+        return;
+    }
+#endif
+
+    QStringList files;
+    QStringList modelUris;
+    for (int i = 0; i < request.modelUris.size(); i++) {
+        if (!cachedNodeSets.contains(request.modelUris.at(i))) {
+            modelUris.append(request.modelUris.at(i));
+            files.append(request.files.at(i));
+        }
+    }
+
+    qint64 bytesTotal = 0;
+    for (const QString& filePath : std::as_const(files))
+        bytesTotal += QFileInfo(filePath).size();
+
+    // Every file is parsed on its own worker with its own parser and fills its own UANodeSet.
+    // The resolve passes work across all nodesets, so they only start after all parses joined.
+    // With lazy loading the required models are only indexed, the selected one is always parsed.
+    const qsizetype selectedIndex = request.modelUris.indexOf(request.selectedModelUri);
+    const QString selectedFile = selectedIndex >= 0 ? request.files.at(selectedIndex) : QString();
+    std::atomic<bool> allParsed = true;
+    const QList<std::shared_ptr<UANodeSet>> parsedNodeSets
+        = QtConcurrent::blockingMapped<QList<std::shared_ptr<UANodeSet>>>(
+            files, [&, lazy, selectedFile](const QString& filePath) {
+                std::shared_ptr<UANodeSet> nodeSet = std::make_shared<UANodeSet>();
+                if (promise.isCanceled())
+                    return nodeSet;
+
+                UaNodeSetParser parser;
+                const bool success = lazy && filePath != selectedFile
+                                         ? parser.index(filePath, nodeSet.get())
+                                         : parser.parse(filePath, nodeSet.get());
+                if (!success)
+                    allParsed = false;
+
+                const qint64 bytes = QFileInfo(filePath).size();
+                const qint64 nodes = nodeSet->loadedNodeCount();
+                QMetaObject::invokeMethod(
+                    this,
+                    [this, generation, filePath, bytes, nodes, bytesTotal]() {
+                        reportFile(generation, filePath, bytes, nodes, bytesTotal);
+                    },
+                    Qt::QueuedConnection);
+                return nodeSet;
+            });
+    if (promise.isCanceled()) {
+        qDebug() << "Loading NodeSets for" << request.selectedModelUri << "canceled";
+        return;
+    }
+    qDebug() << "Parsed" << parsedNodeSets.size() << "NodeSet files in" << timer.elapsed() << "ms,"
+             << cachedNodeSets.size() << "reused from the cache";
+
+    result.nodeSets = cachedNodeSets;
+    for (int i = 0; i < modelUris.size(); i++) {
+        result.nodeSets.insert(modelUris.at(i), parsedNodeSets.at(i));
+    }
+
+    // Only the references of the parsed nodesets are resolved, the cached ones are complete.
+    NodeSetResolver resolver(result.nodeSets);
+    resolver.setResolvedModels(QSet<QString>(cachedNodeSets.keyBegin(), cachedNodeSets.keyEnd()));
+    const qsizetype resolvedNodeCount = resolver.resolve();
+    qDebug() << "Resolved" << resolvedNodeCount << "nodes in" << timer.elapsed() << "ms";
+    qDebug() << "Interned" << AtomTable::instance()->size() << "strings, saved"
+             << AtomTable::instance()->savedBytes() / 1024 << "KiB of duplicated string data";
+
+    // Don't cache a partial result, the next load should report the broken file again.
+    if (allParsed && !lazy)
+        NodeSetCache::instance()->insert(result.nodeSets, fileHashes);
+#ifndef WASM_BUILD
+    if (allParsed && !snapshotKey.isEmpty())
+        NodeSetSnapshot::save(snapshotKey, result.nodeSets);
+#endif
+
+    promise.addResult(std::move(result));
+}
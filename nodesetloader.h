@@ -0,0 +1,74 @@
+// SPDX-FileCopyrightText: 2025 Marius Dege <marius.dege@basyskom.com>
+// SPDX-FileCopyrightText: 2024 Marius Dege <marius.dege@basyskom.com>
+// SPDX-FileCopyrightText: 2024 basysKom GmbH
+
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#ifndef NODESETLOADER_H
+#define NODESETLOADER_H
+
+#include "uanodeset.h"
+#include <QFutureWatcher>
+#include <QMap>
+#include <QObject>
+#include <QPromise>
+#include <QStringList>
+#include <QThreadPool>
+
+// Parses and resolves the nodesets of one companion spec and its required models on a worker
+// thread. The nodesets are only handed out with finished, once they are completely resolved, and
+// belong to the receiving thread from then on. Nodesets of models that a previous result still
+// uses are taken from the NodeSetCache and shared between the results, they are read only.
+class NodeSetLoader : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Request
+    {
+        // model URIs and NodeSet2.xml files of the required models, in the same order
+        QStringList modelUris;
+        QStringList files;
+        QString selectedModelUri;
+        // only index the required models other than the selected one
+        bool lazyLoadDependencies = false;
+    };
+
+    struct Result
+    {
+        QMap<QString, std::shared_ptr<UANodeSet>> nodeSets;
+        QString selectedModelUri;
+    };
+
+    explicit NodeSetLoader(QObject* parent = nullptr);
+    ~NodeSetLoader() override;
+
+    // A load that is still running is canceled, only the last load emits finished.
+    void load(const Request& request);
+    void cancel();
+    bool isLoading() const;
+
+signals:
+    // Emitted on the thread of the loader and only for the current load, the totals never
+    // decrease. Files of a canceled or superseded load are not reported anymore.
+    void fileLoaded(const QString& filePath, qint64 bytes, qint64 nodes);
+    void progressChanged(qint64 bytesLoaded, qint64 bytesTotal, qint64 nodesLoaded);
+    void finished(const NodeSetLoader::Result& result);
+
+private:
+    // Only one load runs at a time, a canceled load finishes its current file before the next
+    // one starts.
+    QThreadPool m_pool;
+    QFutureWatcher<Result> m_watcher;
+    // Incremented by every load and cancel, the workers tag their reports with it
+    quint64 m_generation = 0;
+    qint64 m_bytesLoaded = 0;
+    qint64 m_nodesLoaded = 0;
+
+    void run(QPromise<Result>& promise, const Request& request, quint64 generation);
+    // Called on the thread of the loader for every file a worker finished
+    void reportFile(
+        quint64 generation, const QString& filePath, qint64 bytes, qint64 nodes, qint64 bytesTotal);
+};
+
+#endif // NODESETLOADER_H
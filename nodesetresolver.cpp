@@ -0,0 +1,362 @@
+// SPDX-FileCopyrightText: 2025 Marius Dege <marius.dege@basyskom.com>
+// SPDX-FileCopyrightText: 2024 Marius Dege <marius.dege@basyskom.com>
+// SPDX-FileCopyrightText: 2024 basysKom GmbH
+
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "nodesetresolver.h"
+#include "Util/Utils.h"
+#include <QtConcurrent/QtConcurrentMap>
+#include <algorithm>
+
+namespace {
+// ModellingRules of the UA namespace that make an instance declaration optional
+const UANodeId OptionalModellingRule(0, 80);
+const UANodeId OptionalPlaceholderModellingRule(0, 11508);
+} // namespace
+
+NodeSetResolver::NodeSetResolver(const QMap<QString, std::shared_ptr<UANodeSet>>& nodeSets)
+    : m_nodeSets(nodeSets)
+    , m_referenceTypes(nodeSets)
+    , m_uaNamespace(AtomTable::instance()->find(QStringLiteral("http://opcfoundation.org/UA/")))
+{
+    for (auto it = nodeSets.constBegin(); it != nodeSets.constEnd(); ++it) {
+        m_nodeSetsByNamespace.insert(AtomTable::instance()->find(it.key()), it.value());
+    }
+}
+
+bool NodeSetResolver::isOptionalModellingRule(const Reference& reference) const
+{
+    if (reference.namespaceAtom() != m_uaNamespace)
+        return false;
+    const UANodeId target = reference.targetId().withoutNamespace();
+    return target == OptionalModellingRule || target == OptionalPlaceholderModellingRule;
+}
+
+void NodeSetResolver::setResolvedModels(const QSet<QString>& modelUris)
+{
+    m_resolvedModels = modelUris;
+    m_resolvedNamespaces.clear();
+    for (const QString& modelUri : modelUris) {
+        if (const std::shared_ptr<UANodeSet> nodeSet = m_nodeSets.value(modelUri)) {
+            m_resolvedNamespaces.insert(AtomTable::instance()->find(nodeSet->getNameSpaceUri()));
+        }
+    }
+}
+
+void NodeSetResolver::setParallelLinking(bool parallelLinking)
+{
+    m_parallelLinking = parallelLinking;
+}
+
+qsizetype NodeSetResolver::resolve()
+{
+    // The resolve passes only walk the loaded nodes. Nodes of lazy nodesets get loaded while
+    // resolving and have to be resolved as well, so repeat until no new nodes show up.
+    // Without lazy nodesets this is a single round.
+    qsizetype resolvedNodeCount = -1;
+    while (resolvedNodeCount != loadedNodeCount()) {
+        resolvedNodeCount = loadedNodeCount();
+        resolveParentNode();
+        resolveReferences();
+        resolveDataTypes();
+        resolveMethods();
+    }
+    return resolvedNodeCount;
+}
+
+std::shared_ptr<UANode> NodeSetResolver::findNodeById(
+    Atom namespaceUri, const UANodeId& nodeId) const
+{
+    const auto nodeSet = m_nodeSetsByNamespace.constFind(namespaceUri);
+    if (nodeSet != m_nodeSetsByNamespace.constEnd()) {
+        return (*nodeSet)->findNodeById(nodeId);
+    }
+    qWarning() << "NodeSet not found for namespace:"
+               << AtomTable::instance()->string(namespaceUri);
+    return nullptr;
+}
+
+qsizetype NodeSetResolver::loadedNodeCount() const
+{
+    qsizetype count = 0;
+    for (const std::shared_ptr<UANodeSet>& nodeSet : std::as_const(m_nodeSets)) {
+        count += nodeSet->loadedNodeCount();
+    }
+    return count;
+}
+
+QList<std::shared_ptr<UANodeSet>> NodeSetResolver::unresolvedNodeSets() const
+{
+    QList<std::shared_ptr<UANodeSet>> nodeSets;
+    for (const auto [modelUri, nodeSet] : m_nodeSets.asKeyValueRange()) {
+        if (!m_resolvedModels.contains(modelUri)) {
+            nodeSets.append(nodeSet);
+        }
+    }
+    return nodeSets;
+}
+
+void NodeSetResolver::resolveParentNode()
+{
+    const QList<std::shared_ptr<UANodeSet>> nodeSets = unresolvedNodeSets();
+    for (const std::shared_ptr<UANodeSet>& nodeSet : nodeSets) {
+        auto nodes = nodeSet->loadedNodes();
+        for (auto node : std::as_const(nodes)) {
+            const QByteArrayView parentNodeId = node->parentNodeIdUtf8();
+            if (!parentNodeId.isEmpty()) {
+                auto parentNode = nodeSet->findNodeById(UANodeId::lookupUtf8(parentNodeId));
+                if (parentNode) {
+                    node->setParentNode(parentNode);
+                }
+            }
+        }
+    }
+}
+
+void NodeSetResolver::resolveReferences()
+{
+    // Phase one links every reference to its target. It only reads the node indices, so it runs
+    // in parallel, unless a lazy nodeset would load nodes while it is looked up.
+    const QList<std::shared_ptr<UANodeSet>> nodeSets = unresolvedNodeSets();
+    const bool linkInParallel = m_parallelLinking
+                                && std::none_of(m_nodeSets.cbegin(),
+                                                m_nodeSets.cend(),
+                                                [](const std::shared_ptr<UANodeSet>& nodeSet) {
+                                                    return nodeSet->isLazy();
+                                                });
+    if (linkInParallel) {
+        QList<std::shared_ptr<UANode>> nodes;
+        nodes.reserve(loadedNodeCount());
+        for (const std::shared_ptr<UANodeSet>& nodeSet : nodeSets) {
+            nodes.append(nodeSet->loadedNodes());
+        }
+        // every reference belongs to exactly one node, so no two workers write the same one
+        QtConcurrent::blockingMap(nodes, [this](const std::shared_ptr<UANode>& node) {
+            for (const std::shared_ptr<Reference>& reference : node->references()) {
+                linkReference(*reference);
+            }
+        });
+    }
+
+    // Phase two walks the graph in a fixed order for the steps that depend on it, the optional
+    // flags and the inherited definition fields. The result is the same as linking serially.
+    // keep track of visited nodes to avoid cycles
+    QSet<const UANode*> visitedNodes;
+    // a later round can have loaded supertypes that were missing before
+    m_inheritedDataTypes.clear();
+
+    for (const std::shared_ptr<UANodeSet>& nodeSet : nodeSets) {
+        auto nodes = nodeSet->loadedNodes();
+        for (const auto& node : std::as_const(nodes)) {
+            resolveNodeReferences(node, visitedNodes, linkInParallel);
+        }
+    }
+}
+
+void NodeSetResolver::resolveDataTypes()
+{
+    // Many variables share few datatypes, so every alias and every datatype is looked up only
+    // once per pass and the variables then take their datatype from the index.
+    QHash<UANodeId, std::shared_ptr<UADataType>> dataTypes;
+    const QList<std::shared_ptr<UANodeSet>> nodeSets = unresolvedNodeSets();
+    for (const std::shared_ptr<UANodeSet>& nodeSet : nodeSets) {
+        QHash<Atom, std::shared_ptr<UADataType>> aliases;
+        QList<std::shared_ptr<UANode>> nodes = nodeSet->loadedNodes();
+        for (const auto& node : std::as_const(nodes)) {
+            if (node->typeName() != XmlTags::UAVariable)
+                continue;
+            std::shared_ptr<UAVariable> variable = std::static_pointer_cast<UAVariable>(node);
+            const Atom alias = variable->dataType().definitionNameAtom();
+            auto dataType = aliases.constFind(alias);
+            if (dataType == aliases.constEnd()) {
+                dataType = aliases.insert(
+                    alias, findDataType(nodeSet->getNodeIdByAlias(alias), dataTypes));
+            }
+            if (*dataType) {
+                variable->setDataType(**dataType);
+            }
+        }
+    }
+}
+
+std::shared_ptr<UADataType> NodeSetResolver::findDataType(
+    const QString& nodeId, QHash<UANodeId, std::shared_ptr<UADataType>>& dataTypes) const
+{
+    if (nodeId.isEmpty())
+        return nullptr;
+
+    const UANodeId key = UANodeId::lookup(nodeId).withoutNamespace();
+    if (auto dataType = dataTypes.constFind(key); dataType != dataTypes.constEnd())
+        return *dataType;
+
+    // the last nodeset with a datatype of this id wins
+    std::shared_ptr<UADataType> dataType;
+    for (const std::shared_ptr<UANodeSet>& nodeSet : std::as_const(m_nodeSets)) {
+        std::shared_ptr<UANode> node = nodeSet->findNodeById(key);
+        if (node && node->typeName() == XmlTags::UADataType) {
+            if (auto candidate = std::dynamic_pointer_cast<UADataType>(node))
+                dataType = candidate;
+        }
+    }
+    // The variables get a copy without the references of the datatype node. Neither the models
+    // nor the code generation use them, and they would be deep copied for every variable.
+    if (dataType) {
+        dataType = std::make_shared<UADataType>(*dataType);
+        dataType->clearReferences();
+    }
+    dataTypes.insert(key, dataType);
+    return dataType;
+}
+
+void NodeSetResolver::resolveMethods()
+{
+    const QList<std::shared_ptr<UANodeSet>> nodeSets = unresolvedNodeSets();
+    for (const std::shared_ptr<UANodeSet>& nodeSet : nodeSets) {
+        QList<std::shared_ptr<UANode>> nodes = nodeSet->loadedNodes();
+        for (const std::shared_ptr<UANode>& node : std::as_const(nodes)) {
+            if (node->typeName() == XmlTags::UAMethod) {
+                std::shared_ptr<UAMethod> method = std::dynamic_pointer_cast<UAMethod>(node);
+                for (const std::shared_ptr<Reference>& reference : method->references()) {
+                    if (reference->node()) {
+                        const QByteArrayView browseName = reference->node()->browseNameUtf8();
+                        if (browseName == "InputArguments") {
+                            method->setInputArgument(
+                                std::dynamic_pointer_cast<UAVariable>(reference->node()));
+                        } else if (browseName == "OutputArguments") {
+                            method->setOutputArgument(
+                                std::dynamic_pointer_cast<UAVariable>(reference->node()));
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+std::shared_ptr<UANode> NodeSetResolver::linkReference(Reference& reference) const
+{
+    std::shared_ptr<UANode> referencedNode
+        = findNodeById(reference.namespaceAtom(), reference.targetId());
+    if (referencedNode) {
+        reference.setNode(referencedNode);
+    }
+    return referencedNode;
+}
+
+void NodeSetResolver::resolveNodeReferences(
+    std::shared_ptr<UANode> node, QSet<const UANode*>& visitedNodes, bool linked)
+{
+    // Depth first walk over the reference graph with an explicit stack, long HasSubtype and
+    // HasComponent chains would overflow the small stack of the WASM build otherwise.
+    struct Frame
+    {
+        std::shared_ptr<UANode> node;
+        QList<std::shared_ptr<Reference>> references;
+        qsizetype next = 0;
+    };
+
+    if (visitedNodes.contains(node.get())) {
+        return;
+    }
+    visitedNodes.insert(node.get());
+    QList<Frame> stack{{node, node->references()}};
+
+    while (!stack.isEmpty()) {
+        Frame& frame = stack.last();
+        if (frame.next == frame.references.size()) {
+            // All referenced nodes are linked, the supertypes are completed on demand
+            inheritDefinitionFields(frame.node);
+            stack.removeLast();
+            continue;
+        }
+
+        const std::shared_ptr<Reference> reference = frame.references.at(frame.next++);
+
+        // The ModellingRule is identified by its NodeId, so this works without the UA nodeset
+        if (m_referenceTypes.isSubtypeOf(
+                frame.node->namespaceAtom(),
+                reference->referenceTypeAtom(),
+                ReferenceTypeLattice::HasModellingRule)
+            && isOptionalModellingRule(*reference)) {
+            frame.node->setIsOptional(true);
+        }
+
+        const std::shared_ptr<UANode> referencedNode = linked ? reference->node()
+                                                              : linkReference(*reference);
+        if (!referencedNode) {
+            continue;
+        }
+
+        // the nodes of resolved nodesets are complete already
+        if (m_resolvedNamespaces.contains(referencedNode->namespaceAtom())) {
+            continue;
+        }
+        if (!visitedNodes.contains(referencedNode.get())) {
+            visitedNodes.insert(referencedNode.get());
+            // invalidates frame
+            stack.append({referencedNode, referencedNode->references()});
+        }
+    }
+}
+
+QList<std::shared_ptr<UADataType>> NodeSetResolver::superTypes(const UADataType& dataType) const
+{
+    // The supertype is the target of the inverse HasSubtype. Forward HasSubtype references point
+    // to the subtypes, which inherit from this type instead.
+    QList<std::shared_ptr<UADataType>> superTypes;
+    for (const std::shared_ptr<Reference>& reference : dataType.references()) {
+        if (reference->isForward()
+            || !m_referenceTypes.isSubtypeOf(
+                dataType.namespaceAtom(),
+                reference->referenceTypeAtom(),
+                ReferenceTypeLattice::HasSubtype)) {
+            continue;
+        }
+        if (auto superType = std::dynamic_pointer_cast<UADataType>(reference->node()))
+            superTypes.append(superType);
+    }
+    return superTypes;
+}
+
+void NodeSetResolver::inheritDefinitionFields(const std::shared_ptr<UANode>& node)
+{
+    std::shared_ptr<UADataType> dataTypeNode = std::dynamic_pointer_cast<UADataType>(node);
+    if (!dataTypeNode || m_inheritedDataTypes.contains(node.get())) {
+        return;
+    }
+
+    // Walk up the supertype chain to the first complete type, one that already inherited its
+    // fields or belongs to a resolved nodeset. A DataType has a single supertype. Every type is
+    // marked when it is collected, so a HasSubtype cycle ends the walk.
+    struct Link
+    {
+        std::shared_ptr<UADataType> dataType;
+        QList<std::shared_ptr<UADataType>> superTypes;
+    };
+    QList<Link> chain;
+    std::shared_ptr<UADataType> next = dataTypeNode;
+    while (next) {
+        m_inheritedDataTypes.insert(next.get());
+        const QList<std::shared_ptr<UADataType>> nextSuperTypes = superTypes(*next);
+        chain.append({next, nextSuperTypes});
+        next = nullptr;
+        for (const std::shared_ptr<UADataType>& superType : nextSuperTypes) {
+            if (!m_inheritedDataTypes.contains(superType.get())
+                && !m_resolvedNamespaces.contains(superType->namespaceAtom())) {
+                next = superType;
+                break;
+            }
+        }
+    }
+
+    // Top down, so every type passes on the fields it inherited itself
+    for (auto link = chain.crbegin(); link != chain.crend(); ++link) {
+        for (const std::shared_ptr<UADataType>& superType : link->superTypes) {
+            const QMap<QString, QString> fields = superType->definitionFields();
+            for (const auto [key, value] : fields.asKeyValueRange()) {
+                link->dataType->addDefinitionField(key, value);
+            }
+        }
+    }
+}
@@ -0,0 +1,71 @@
+// SPDX-FileCopyrightText: 2025 Marius Dege <marius.dege@basyskom.com>
+// SPDX-FileCopyrightText: 2024 Marius Dege <marius.dege@basyskom.com>
+// SPDX-FileCopyrightText: 2024 basysKom GmbH
+
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#ifndef NODESETRESOLVER_H
+#define NODESETRESOLVER_H
+
+#include "referencetypelattice.h"
+#include "uanodeset.h"
+#include <QHash>
+#include <QMap>
+#include <QSet>
+#include <QString>
+
+// Links the parsed nodesets of one companion spec and its required models: parent nodes,
+// reference targets, data types and method arguments. Works on the nodesets keyed by their
+// model URI and does not depend on the GUI, so it can run headless.
+class NodeSetResolver
+{
+public:
+    explicit NodeSetResolver(const QMap<QString, std::shared_ptr<UANodeSet>>& nodeSets);
+
+    // Nodesets of the map that are already resolved, e.g. shared from the NodeSetCache. They are
+    // only looked up, the passes neither walk nor change them.
+    void setResolvedModels(const QSet<QString>& modelUris);
+    // Link the references in parallel before the ordered walk (default). Only done when no
+    // nodeset is lazy; the result is the same as linking serially.
+    void setParallelLinking(bool parallelLinking);
+
+    // Runs all passes until no lazy node gets loaded anymore. Returns the number of resolved nodes.
+    qsizetype resolve();
+
+    void resolveParentNode();
+    void resolveReferences();
+    void resolveDataTypes();
+    void resolveMethods();
+
+    qsizetype loadedNodeCount() const;
+
+private:
+    const QMap<QString, std::shared_ptr<UANodeSet>>& m_nodeSets;
+    // The nodesets by the atom of their namespace URI, so links are looked up without the
+    // AtomTable lock and the parallel link phase only reads
+    QHash<Atom, std::shared_ptr<UANodeSet>> m_nodeSetsByNamespace;
+    ReferenceTypeLattice m_referenceTypes;
+    QSet<QString> m_resolvedModels;
+    // namespaces of the nodes in the resolved nodesets
+    QSet<Atom> m_resolvedNamespaces;
+    Atom m_uaNamespace = 0;
+    bool m_parallelLinking = true;
+    // datatypes that already carry the definition fields of their supertypes
+    QSet<const UANode*> m_inheritedDataTypes;
+
+    QList<std::shared_ptr<UANodeSet>> unresolvedNodeSets() const;
+
+    std::shared_ptr<UANode> findNodeById(Atom namespaceUri, const UANodeId& nodeId) const;
+    std::shared_ptr<UADataType> findDataType(
+        const QString& nodeId, QHash<UANodeId, std::shared_ptr<UADataType>>& dataTypes) const;
+    std::shared_ptr<UANode> linkReference(Reference& reference) const;
+    // Whether the reference targets the Optional or OptionalPlaceholder ModellingRule
+    bool isOptionalModellingRule(const Reference& reference) const;
+    // With linked, the references already point to their targets and are not looked up again.
+    void resolveNodeReferences(
+        std::shared_ptr<UANode> node, QSet<const UANode*>& visitedNodes, bool linked);
+    QList<std::shared_ptr<UADataType>> superTypes(const UADataType& dataType) const;
+    void inheritDefinitionFields(const std::shared_ptr<UANode>& node);
+};
+
+#endif // NODESETRESOLVER_H
@@ -0,0 +1,528 @@
+// SPDX-FileCopyrightText: 2025 Marius Dege <marius.dege@basyskom.com>
+// SPDX-FileCopyrightText: 2024 Marius Dege <marius.dege@basyskom.com>
+// SPDX-FileCopyrightText: 2024 basysKom GmbH
+
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "nodesetsnapshot.h"
+#include "Util/Utils.h"
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+namespace {
+
+constexpr quint32 SnapshotMagic = 0x55414e53; // "UANS"
+
+enum class NodeKind : quint8 {
+    Object,
+    DataType,
+    Variable,
+    Method,
+    VariableType,
+    ObjectType,
+    ReferenceType,
+};
+
+// Position of a node in the snapshot: index of its nodeset and index in UANodeSet::nodes().
+using NodeLocation = std::pair<qint32, qint32>;
+const NodeLocation NoNode{-1, -1};
+
+NodeKind kindOf(const UANode& node)
+{
+    const QString typeName = node.typeName();
+    if (typeName == XmlTags::UADataType)
+        return NodeKind::DataType;
+    if (typeName == XmlTags::UAVariable)
+        return NodeKind::Variable;
+    if (typeName == XmlTags::UAMethod)
+        return NodeKind::Method;
+    if (typeName == XmlTags::UAVariableType)
+        return NodeKind::VariableType;
+    if (typeName == XmlTags::UAObjectType)
+        return NodeKind::ObjectType;
+    if (typeName == XmlTags::UAReferenceType)
+        return NodeKind::ReferenceType;
+    return NodeKind::Object;
+}
+
+std::shared_ptr<UANode> createNode(NodeKind kind, UANodeSet& nodeSet)
+{
+    switch (kind) {
+    case NodeKind::DataType:
+        return nodeSet.create<UADataType>();
+    case NodeKind::Variable:
+        return nodeSet.create<UAVariable>();
+    case NodeKind::Method:
+        return nodeSet.create<UAMethod>();
+    case NodeKind::VariableType:
+        return nodeSet.create<UAVariableType>();
+    case NodeKind::ObjectType:
+        return nodeSet.create<UAObjectType>();
+    case NodeKind::ReferenceType:
+        return nodeSet.create<UAReferenceType>();
+    case NodeKind::Object:
+        break;
+    }
+    return nodeSet.create<UAObject>();
+}
+
+void writeLocation(QDataStream& out, const NodeLocation& location)
+{
+    out << location.first << location.second;
+}
+
+NodeLocation readLocation(QDataStream& in)
+{
+    NodeLocation location = NoNode;
+    in >> location.first >> location.second;
+    return location;
+}
+
+// Strings are written as the UTF-8 the nodes store, read back as QByteArray
+void writeUtf8(QDataStream& out, QByteArrayView string)
+{
+    out.writeBytes(string.data(), string.size());
+}
+
+// Atoms are looked up in the AtomTable once per snapshot, not once per node
+class AtomWriter
+{
+public:
+    void write(QDataStream& out, Atom atom)
+    {
+        auto it = m_strings.constFind(atom);
+        if (it == m_strings.constEnd())
+            it = m_strings.insert(atom, AtomTable::instance()->string(atom).toUtf8());
+        writeUtf8(out, *it);
+    }
+
+private:
+    QHash<Atom, QByteArray> m_strings;
+};
+
+// Reads what AtomWriter wrote, every distinct string is interned once per snapshot
+class AtomReader
+{
+public:
+    Atom read(QDataStream& in)
+    {
+        QByteArray string;
+        in >> string;
+        auto it = m_atoms.constFind(string);
+        if (it == m_atoms.constEnd())
+            it = m_atoms.insert(string, AtomTable::instance()->intern(QString::fromUtf8(string)));
+        return *it;
+    }
+
+private:
+    QHash<QByteArray, Atom> m_atoms;
+};
+
+void writeBase(QDataStream& out, AtomWriter& atoms, const UANode& node)
+{
+    writeUtf8(out, node.nodeIdUtf8());
+    writeUtf8(out, node.browseNameUtf8());
+    writeUtf8(out, node.baseBrowseNameUtf8());
+    writeUtf8(out, node.uniqueBaseBrowseNameUtf8());
+    writeUtf8(out, node.displayNameUtf8());
+    writeUtf8(out, node.nodeVariableNameUtf8());
+    writeUtf8(out, node.descriptionUtf8());
+    writeUtf8(out, node.parentNodeIdUtf8());
+    atoms.write(out, node.namespaceAtom());
+    out << node.isOptional() << node.isRootNode();
+}
+
+// The strings go into the node as they are stored, the variable name is not derived again
+void readBase(QDataStream& in, AtomReader& atoms, UANode& node)
+{
+    UANode::Utf8Strings strings;
+    in >> strings.nodeId >> strings.browseName >> strings.baseBrowseName
+        >> strings.uniqueBaseBrowseName >> strings.displayName >> strings.nodeVariableName
+        >> strings.description >> strings.parentNodeId;
+    const Atom namespaceString = atoms.read(in);
+    bool isOptional = false;
+    bool isRootNode = false;
+    in >> isOptional >> isRootNode;
+
+    node.setUtf8Strings(std::move(strings));
+    node.setNamespaceAtom(namespaceString);
+    node.setIsOptional(isOptional);
+    node.setIsRootNode(isRootNode);
+}
+
+void writeDefinition(QDataStream& out, const UADataType& dataType)
+{
+    out << dataType.definitionName() << dataType.definitionFields() << dataType.isEnum();
+}
+
+void readDefinition(QDataStream& in, UADataType& dataType)
+{
+    QString definitionName;
+    QMap<QString, QString> definitionFields;
+    bool isEnum = false;
+    in >> definitionName >> definitionFields >> isEnum;
+
+    dataType.setDefinitionName(definitionName);
+    for (const auto& [fieldName, fieldType] : definitionFields.asKeyValueRange()) {
+        dataType.addDefinitionField(fieldName, fieldType);
+    }
+    dataType.setIsEnum(isEnum);
+}
+
+void writeVariable(QDataStream& out, AtomWriter& atoms, const UAVariable& variable)
+{
+    // The resolved datatype is a copy of the UADataType node. Its references are not needed
+    // by the models or the code generation, so only the node data and the definition are stored.
+    const UADataType& dataType = variable.dataType();
+    writeBase(out, atoms, dataType);
+    writeDefinition(out, dataType);
+
+    const QList<Argument>& arguments = variable.arguments();
+    out << qint32(arguments.size());
+    for (const Argument& argument : arguments) {
+        out << argument.name << argument.dataTypeIdentifier << qint32(argument.valueRank);
+    }
+    out << qint32(variable.arrayDimensions()) << qint32(variable.valueRank());
+    out << variable.value();
+}
+
+void readVariable(QDataStream& in, AtomReader& atoms, UAVariable& variable)
+{
+    UADataType dataType;
+    readBase(in, atoms, dataType);
+    readDefinition(in, dataType);
+    variable.setDataType(std::move(dataType));
+
+    qint32 argumentCount = 0;
+    in >> argumentCount;
+    QList<Argument> arguments;
+    for (qint32 i = 0; i < argumentCount && in.status() == QDataStream::Ok; ++i) {
+        Argument argument;
+        qint32 valueRank = -1;
+        in >> argument.name >> argument.dataTypeIdentifier >> valueRank;
+        argument.valueRank = valueRank;
+        arguments.append(argument);
+    }
+    variable.setArguments(std::move(arguments));
+
+    qint32 arrayDimensions = 0;
+    qint32 valueRank = 0;
+    in >> arrayDimensions >> valueRank;
+    variable.setArrayDimensions(arrayDimensions);
+    variable.setValueRank(valueRank);
+
+    UAValue value;
+    in >> value;
+    variable.setValue(std::move(value));
+}
+
+} // namespace
+
+QString NodeSetSnapshot::cacheKey(const QStringList& files, const QList<QByteArray>& fileHashes)
+{
+    // MD5 is only used to detect changed files, not for security.
+    QCryptographicHash hash(QCryptographicHash::Md5);
+    const quint32 version = FormatVersion;
+    hash.addData(QByteArrayView(reinterpret_cast<const char*>(&version), sizeof(version)));
+
+    for (qsizetype i = 0; i < files.size(); ++i) {
+        hash.addData(files.at(i).toUtf8());
+        hash.addData(fileHashes.value(i));
+    }
+
+    return QString::fromLatin1(hash.result().toHex());
+}
+
+QString NodeSetSnapshot::cacheDirectory()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation)
+           + QStringLiteral("/nodesets");
+}
+
+QString NodeSetSnapshot::snapshotFilePath(const QString& key)
+{
+    return cacheDirectory() + QStringLiteral("/") + key + QStringLiteral(".uans");
+}
+
+bool NodeSetSnapshot::load(const QString& key, QMap<QString, std::shared_ptr<UANodeSet>>& nodeSets)
+{
+    QFile file(snapshotFilePath(key));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    if (!read(&file, nodeSets)) {
+        qDebug() << "Ignoring unreadable snapshot:" << file.fileName();
+        return false;
+    }
+    return true;
+}
+
+bool NodeSetSnapshot::read(QIODevice* device, QMap<QString, std::shared_ptr<UANodeSet>>& nodeSets)
+{
+    QDataStream in(device);
+    in.setVersion(QDataStream::Qt_6_8);
+
+    quint32 magic = 0;
+    quint32 version = 0;
+    in >> magic >> version;
+    if (magic != SnapshotMagic || version != FormatVersion) {
+        qDebug() << "Snapshot has an unsupported format";
+        return false;
+    }
+
+    // Links between nodes are stored as locations. They are resolved after all nodes are read.
+    struct PendingReference
+    {
+        std::shared_ptr<Reference> reference;
+        NodeLocation target;
+    };
+    struct PendingNode
+    {
+        std::shared_ptr<UANode> node;
+        NodeLocation parent;
+        NodeLocation inputArgument;
+        NodeLocation outputArgument;
+    };
+
+    QList<QString> modelUris;
+    QList<std::shared_ptr<UANodeSet>> loadedNodeSets;
+    QList<QList<std::shared_ptr<UANode>>> loadedNodes;
+    QList<PendingReference> pendingReferences;
+    QList<PendingNode> pendingNodes;
+    AtomReader atoms;
+
+    qint32 nodeSetCount = 0;
+    in >> nodeSetCount;
+    for (qint32 setIndex = 0; setIndex < nodeSetCount && in.status() == QDataStream::Ok;
+         ++setIndex) {
+        QString modelUri;
+        QString namespaceUri;
+        QMap<int, QString> namespaceMap;
+        QMap<QString, QString> aliases;
+        bool hasCustomTypes = false;
+        qint32 nodeCount = 0;
+        in >> modelUri >> namespaceUri >> namespaceMap >> aliases >> hasCustomTypes >> nodeCount;
+
+        std::shared_ptr<UANodeSet> nodeSet = std::make_shared<UANodeSet>();
+        nodeSet->setNamespaceUri(namespaceUri);
+        for (const auto& [index, uri] : namespaceMap.asKeyValueRange()) {
+            nodeSet->addNamespaceMapEntry(index, uri);
+        }
+        for (const auto& [alias, target] : aliases.asKeyValueRange()) {
+            nodeSet->addAlias(alias, target);
+        }
+        nodeSet->setHasCustomTypes(hasCustomTypes);
+
+        QList<std::shared_ptr<UANode>> nodes;
+        nodes.reserve(nodeCount);
+        for (qint32 i = 0; i < nodeCount && in.status() == QDataStream::Ok; ++i) {
+            quint8 kindValue = 0;
+            in >> kindValue;
+            const NodeKind kind = static_cast<NodeKind>(kindValue);
+
+            PendingNode pending{createNode(kind, *nodeSet), NoNode, NoNode, NoNode};
+            std::shared_ptr<UANode> node = pending.node;
+            readBase(in, atoms, *node);
+
+            switch (kind) {
+            case NodeKind::DataType:
+                readDefinition(in, *std::static_pointer_cast<UADataType>(node));
+                break;
+            case NodeKind::Variable:
+                readVariable(in, atoms, *std::static_pointer_cast<UAVariable>(node));
+                break;
+            case NodeKind::VariableType: {
+                auto variableType = std::static_pointer_cast<UAVariableType>(node);
+                readVariable(in, atoms, *variableType);
+                bool isAbstract = false;
+                in >> isAbstract;
+                variableType->setIsAbstract(isAbstract);
+                break;
+            }
+            case NodeKind::ObjectType: {
+                bool isAbstract = false;
+                in >> isAbstract;
+                std::static_pointer_cast<UAObjectType>(node)->setIsAbstract(isAbstract);
+                break;
+            }
+            case NodeKind::ReferenceType: {
+                bool isAbstract = false;
+                in >> isAbstract;
+                std::static_pointer_cast<UAReferenceType>(node)->setIsAbstract(isAbstract);
+                break;
+            }
+            case NodeKind::Method:
+                pending.inputArgument = readLocation(in);
+                pending.outputArgument = readLocation(in);
+                break;
+            case NodeKind::Object:
+                break;
+            }
+
+            qint32 referenceCount = 0;
+            in >> referenceCount;
+            for (qint32 r = 0; r < referenceCount && in.status() == QDataStream::Ok; ++r) {
+                const Atom referenceType = atoms.read(in);
+                QByteArray targetNodeId;
+                bool isForward = true;
+                in >> targetNodeId >> isForward;
+                const Atom namespaceString = atoms.read(in);
+                std::shared_ptr<Reference> reference = nodeSet->create<Reference>(
+                    referenceType, targetNodeId, isForward, namespaceString);
+                node->addReference(reference);
+                pendingReferences.append({reference, readLocation(in)});
+            }
+            pending.parent = readLocation(in);
+
+            nodeSet->addNode(node);
+            nodes.append(node);
+            pendingNodes.append(pending);
+        }
+
+        nodeSet->sortNodes();
+        modelUris.append(modelUri);
+        loadedNodeSets.append(nodeSet);
+        loadedNodes.append(nodes);
+    }
+
+    if (in.status() != QDataStream::Ok) {
+        qWarning() << "Snapshot is truncated or corrupt";
+        return false;
+    }
+
+    auto nodeAt = [&loadedNodes](const NodeLocation& location) -> std::shared_ptr<UANode> {
+        if (location.first < 0 || location.first >= loadedNodes.size())
+            return nullptr;
+        const QList<std::shared_ptr<UANode>>& nodes = loadedNodes.at(location.first);
+        if (location.second < 0 || location.second >= nodes.size())
+            return nullptr;
+        return nodes.at(location.second);
+    };
+
+    for (const PendingReference& pending : std::as_const(pendingReferences)) {
+        if (std::shared_ptr<UANode> target = nodeAt(pending.target)) {
+            pending.reference->setNode(target);
+        }
+    }
+    for (const PendingNode& pending : std::as_const(pendingNodes)) {
+        if (std::shared_ptr<UANode> parent = nodeAt(pending.parent)) {
+            pending.node->setParentNode(parent);
+        }
+        if (auto method = std::dynamic_pointer_cast<UAMethod>(pending.node)) {
+            method->setInputArgument(
+                std::dynamic_pointer_cast<UAVariable>(nodeAt(pending.inputArgument)));
+            method->setOutputArgument(
+                std::dynamic_pointer_cast<UAVariable>(nodeAt(pending.outputArgument)));
+        }
+    }
+
+    for (int i = 0; i < modelUris.size(); ++i) {
+        nodeSets.insert(modelUris.at(i), loadedNodeSets.at(i));
+    }
+    return true;
+}
+
+bool NodeSetSnapshot::save(
+    const QString& key, const QMap<QString, std::shared_ptr<UANodeSet>>& nodeSets)
+{
+    if (!QDir().mkpath(cacheDirectory())) {
+        qWarning() << "Could not create snapshot directory:" << cacheDirectory();
+        return false;
+    }
+
+    QSaveFile file(snapshotFilePath(key));
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Could not open snapshot for writing:" << file.errorString();
+        return false;
+    }
+
+    if (!write(&file, nodeSets)) {
+        file.cancelWriting();
+        return false;
+    }
+    return file.commit();
+}
+
+bool NodeSetSnapshot::write(
+    QIODevice* device, const QMap<QString, std::shared_ptr<UANodeSet>>& nodeSets)
+{
+    // Every node gets its location first, so references can be written as indices.
+    QHash<const UANode*, NodeLocation> locations;
+    QList<QList<std::shared_ptr<UANode>>> nodesBySet;
+    for (const std::shared_ptr<UANodeSet>& nodeSet : nodeSets) {
+        const QList<std::shared_ptr<UANode>> nodes = nodeSet->nodes();
+        for (qint32 i = 0; i < nodes.size(); ++i) {
+            locations.insert(nodes.at(i).get(), {qint32(nodesBySet.size()), i});
+        }
+        nodesBySet.append(nodes);
+    }
+    auto locationOf = [&locations](const std::shared_ptr<UANode>& node) {
+        return node ? locations.value(node.get(), NoNode) : NoNode;
+    };
+
+    QDataStream out(device);
+    out.setVersion(QDataStream::Qt_6_8);
+    out << SnapshotMagic << FormatVersion << qint32(nodeSets.size());
+
+    AtomWriter atoms;
+
+    qint32 setIndex = 0;
+    for (auto it = nodeSets.constBegin(); it != nodeSets.constEnd(); ++it) {
+        const std::shared_ptr<UANodeSet>& nodeSet = it.value();
+        const QList<std::shared_ptr<UANode>>& nodes = nodesBySet.at(setIndex++);
+        out << it.key() << nodeSet->getNameSpaceUri() << nodeSet->namespaceMap()
+            << nodeSet->aliasMap() << nodeSet->getHasCustomTypes() << qint32(nodes.size());
+
+        for (const std::shared_ptr<UANode>& node : nodes) {
+            const NodeKind kind = kindOf(*node);
+            out << static_cast<quint8>(kind);
+            writeBase(out, atoms, *node);
+
+            switch (kind) {
+            case NodeKind::DataType:
+                writeDefinition(out, *std::static_pointer_cast<UADataType>(node));
+                break;
+            case NodeKind::Variable:
+                writeVariable(out, atoms, *std::static_pointer_cast<UAVariable>(node));
+                break;
+            case NodeKind::VariableType: {
+                auto variableType = std::static_pointer_cast<UAVariableType>(node);
+                writeVariable(out, atoms, *variableType);
+                out << variableType->isAbstract();
+                break;
+            }
+            case NodeKind::ObjectType:
+                out << std::static_pointer_cast<UAObjectType>(node)->isAbstract();
+                break;
+            case NodeKind::ReferenceType:
+                out << std::static_pointer_cast<UAReferenceType>(node)->isAbstract();
+                break;
+            case NodeKind::Method: {
+                auto method = std::static_pointer_cast<UAMethod>(node);
+                writeLocation(out, locationOf(method->inputArgument()));
+                writeLocation(out, locationOf(method->outputArgument()));
+                break;
+            }
+            case NodeKind::Object:
+                break;
+            }
+
+            const QList<std::shared_ptr<Reference>>& references = node->references();
+            out << qint32(references.size());
+            for (const std::shared_ptr<Reference>& reference : references) {
+                atoms.write(out, reference->referenceTypeAtom());
+                writeUtf8(out, reference->targetNodeIdUtf8());
+                out << reference->isForward();
+                atoms.write(out, reference->namespaceAtom());
+                writeLocation(out, locationOf(reference->node()));
+            }
+            writeLocation(out, locationOf(node->parentNode().lock()));
+        }
+    }
+
+    return out.status() == QDataStream::Ok;
+}
@@ -0,0 +1,40 @@
+// SPDX-FileCopyrightText: 2025 Marius Dege <marius.dege@basyskom.com>
+// SPDX-FileCopyrightText: 2024 Marius Dege <marius.dege@basyskom.com>
+// SPDX-FileCopyrightText: 2024 basysKom GmbH
+
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#ifndef NODESETSNAPSHOT_H
+#define NODESETSNAPSHOT_H
+
+#include "uanodeset.h"
+#include <QIODevice>
+#include <QMap>
+#include <QString>
+#include <QStringList>
+
+// Binary snapshot of a fully resolved group of nodesets (one companion spec and all its required
+// models). Snapshots are stored in the local cache directory and are keyed by the paths and
+// content hashes of the source files, so a changed NodeSet2.xml never loads a stale snapshot.
+class NodeSetSnapshot
+{
+public:
+    // Bump whenever the serialized layout changes. Snapshots of other versions are ignored.
+    static constexpr quint32 FormatVersion = 5;
+
+    // fileHashes are the NodeSetCache::fileHash of the files, in the same order
+    static QString cacheKey(const QStringList& files, const QList<QByteArray>& fileHashes);
+    static QString cacheDirectory();
+
+    static bool load(const QString& key, QMap<QString, std::shared_ptr<UANodeSet>>& nodeSets);
+    static bool save(const QString& key, const QMap<QString, std::shared_ptr<UANodeSet>>& nodeSets);
+    // Serializes the nodesets in the snapshot format. Equal nodesets give identical bytes.
+    static bool write(QIODevice* device, const QMap<QString, std::shared_ptr<UANodeSet>>& nodeSets);
+    // Reads what write() wrote, false if the format or the data does not fit
+    static bool read(QIODevice* device, QMap<QString, std::shared_ptr<UANodeSet>>& nodeSets);
+
+private:
+    static QString snapshotFilePath(const QString& key);
+};
+
+#endif // NODESETSNAPSHOT_H
@@ -0,0 +1,403 @@
+// SPDX-FileCopyrightText: 2025 Marius Dege <marius.dege@basyskom.com>
+// SPDX-FileCopyrightText: 2024 Marius Dege <marius.dege@basyskom.com>
+// SPDX-FileCopyrightText: 2024 basysKom GmbH
+
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "nodesettokenizer.h"
+#include <cstring>
+
+namespace {
+
+bool isWhitespace(char c)
+{
+    return c == ' ' || c == '\n' || c == '\t' || c == '\r';
+}
+
+bool isNameEnd(char c)
+{
+    return isWhitespace(c) || c == '>' || c == '/' || c == '=';
+}
+
+QByteArrayView localName(QByteArrayView qualifiedName)
+{
+    const qsizetype colon = qualifiedName.indexOf(':');
+    return colon >= 0 ? qualifiedName.sliced(colon + 1) : qualifiedName;
+}
+
+// offset of the first c in data starting at from, -1 if there is none
+qsizetype find(QByteArrayView data, qsizetype from, char c)
+{
+    if (from >= data.size())
+        return -1;
+    const void* found = std::memchr(data.data() + from, c, data.size() - from);
+    return found ? static_cast<const char*>(found) - data.data() : -1;
+}
+
+bool contains(QByteArrayView data, char c)
+{
+    return !data.isEmpty() && std::memchr(data.data(), c, data.size());
+}
+
+// &lt; &gt; &amp; &apos; &quot; &#...; and &#x...;
+bool decodeEntity(QByteArrayView entity, char32_t& codePoint)
+{
+    if (entity == "lt")
+        codePoint = '<';
+    else if (entity == "gt")
+        codePoint = '>';
+    else if (entity == "amp")
+        codePoint = '&';
+    else if (entity == "apos")
+        codePoint = '\'';
+    else if (entity == "quot")
+        codePoint = '"';
+    else if (entity.startsWith('#')) {
+        bool ok = false;
+        const uint value = entity.startsWith("#x") ? entity.sliced(2).toUInt(&ok, 16)
+                                                   : entity.sliced(1).toUInt(&ok, 10);
+        if (!ok || value == 0 || value > 0x10FFFF)
+            return false;
+        codePoint = value;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// Checks the entity references in a text or attribute value
+bool validEntities(QByteArrayView raw)
+{
+    qsizetype position = 0;
+    while ((position = find(raw, position, '&')) >= 0) {
+        const qsizetype end = find(raw, position, ';');
+        char32_t codePoint = 0;
+        if (end < 0 || !decodeEntity(raw.sliced(position + 1, end - position - 1), codePoint))
+            return false;
+        position = end + 1;
+    }
+    return true;
+}
+
+} // namespace
+
+QString NodeSetTokenizer::Text::toString() const
+{
+    if (!m_needsDecoding)
+        return QString::fromUtf8(m_raw);
+
+    // Line endings become \n, in attribute values all whitespace becomes a space, like in
+    // QXmlStreamReader.
+    QByteArray decoded;
+    decoded.reserve(m_raw.size());
+    for (qsizetype i = 0; i < m_raw.size(); ++i) {
+        const char c = m_raw.at(i);
+        if (c == '\r') {
+            if (i + 1 < m_raw.size() && m_raw.at(i + 1) == '\n')
+                ++i;
+            decoded.append(m_kind == Kind::Attribute ? ' ' : '\n');
+        } else if (m_kind == Kind::Attribute && (c == '\n' || c == '\t')) {
+            decoded.append(' ');
+        } else if (c == '&' && m_kind != Kind::CData) {
+            // validated while tokenizing
+            const qsizetype end = m_raw.indexOf(';', i);
+            char32_t codePoint = 0;
+            decodeEntity(m_raw.sliced(i + 1, end - i - 1), codePoint);
+            decoded.append(QString::fromUcs4(&codePoint, 1).toUtf8());
+            i = end;
+        } else {
+            decoded.append(c);
+        }
+    }
+    return QString::fromUtf8(decoded);
+}
+
+int NodeSetTokenizer::Text::toInt() const
+{
+    return toString().toInt();
+}
+
+bool NodeSetTokenizer::Text::operator==(QLatin1StringView other) const
+{
+    if (!m_needsDecoding)
+        return m_raw == QByteArrayView(other.data(), other.size());
+    return toString() == other;
+}
+
+NodeSetTokenizer::Text NodeSetTokenizer::Attributes::value(QAnyStringView name) const
+{
+    for (const Attribute& attribute : *this) {
+        if (QAnyStringView::equal(QUtf8StringView(attribute.name()), name))
+            return attribute.value();
+    }
+    return Text();
+}
+
+bool NodeSetTokenizer::Attributes::hasAttribute(QAnyStringView name) const
+{
+    for (const Attribute& attribute : *this) {
+        if (QAnyStringView::equal(QUtf8StringView(attribute.name()), name))
+            return true;
+    }
+    return false;
+}
+
+bool NodeSetTokenizer::decodeAttributeValue(QByteArrayView raw, QString& value)
+{
+    if (contains(raw, '&') && !validEntities(raw))
+        return false;
+    value = Text(raw, Text::Kind::Attribute, true).toString();
+    return true;
+}
+
+NodeSetTokenizer::NodeSetTokenizer(QByteArrayView data)
+    : m_data(data)
+{
+    // UTF-8 byte order mark
+    if (m_data.startsWith("\xEF\xBB\xBF"))
+        m_position = 3;
+}
+
+NodeSetTokenizer::TokenType NodeSetTokenizer::raiseError(const char* message)
+{
+    m_errorString = QString::fromLatin1(message);
+    m_tokenType = Invalid;
+    return m_tokenType;
+}
+
+NodeSetTokenizer::TokenType NodeSetTokenizer::readNext()
+{
+    if (atEnd())
+        return m_tokenType;
+
+    m_attributes.clear();
+    m_text = Text();
+
+    if (m_pendingEndElement) {
+        // second half of an empty element tag
+        m_pendingEndElement = false;
+        m_openElements.removeLast();
+        m_tokenType = EndElement;
+        return m_tokenType;
+    }
+
+    while (m_position < m_data.size()) {
+        if (m_data.at(m_position) != '<')
+            return readCharacters();
+
+        const QByteArrayView markup = m_data.sliced(m_position);
+        if (markup.startsWith("</"))
+            return readEndElement();
+        if (markup.startsWith("<?")) {
+            // The declaration may only name UTF-8, everything else goes to QXmlStreamReader.
+            const qsizetype end = m_data.indexOf("?>", m_position);
+            if (end < 0)
+                return raiseError("Unterminated processing instruction");
+            const QByteArrayView instruction = m_data.sliced(m_position, end - m_position);
+            const qsizetype encoding = instruction.indexOf("encoding");
+            if (encoding >= 0) {
+                const QByteArrayView value = instruction.sliced(encoding + 8);
+                if (!value.contains("utf-8") && !value.contains("UTF-8"))
+                    return raiseError("Unsupported encoding");
+            }
+            m_position = end + 2;
+            continue;
+        }
+        if (markup.startsWith("<!--")) {
+            if (!skipUntil("-->"))
+                return raiseError("Unterminated comment");
+            continue;
+        }
+        if (markup.startsWith("<![CDATA[")) {
+            if (m_openElements.isEmpty())
+                return raiseError("Character data outside of the root element");
+            const qsizetype start = m_position + 9;
+            const qsizetype end = m_data.indexOf("]]>", start);
+            if (end < 0)
+                return raiseError("Unterminated CDATA section");
+            const QByteArrayView raw = m_data.sliced(start, end - start);
+            m_text = Text(raw, Text::Kind::CData, contains(raw, '\r'));
+            m_position = end + 3;
+            m_tokenType = Characters;
+            return m_tokenType;
+        }
+        if (markup.startsWith("<!"))
+            return raiseError("DTDs are not supported");
+        return readStartElement();
+    }
+
+    if (!m_openElements.isEmpty())
+        return raiseError("Premature end of document");
+    m_tokenType = EndDocument;
+    return m_tokenType;
+}
+
+NodeSetTokenizer::TokenType NodeSetTokenizer::readCharacters()
+{
+    qsizetype end = find(m_data, m_position, '<');
+    if (end < 0)
+        end = m_data.size();
+    const QByteArrayView raw = m_data.sliced(m_position, end - m_position);
+    m_position = end;
+
+    if (m_openElements.isEmpty()) {
+        // only whitespace is allowed around the root element
+        for (const char c : raw) {
+            if (!isWhitespace(c))
+                return raiseError("Character data outside of the root element");
+        }
+        return readNext();
+    }
+
+    const bool hasEntities = contains(raw, '&');
+    if (hasEntities && !validEntities(raw))
+        return raiseError("Invalid entity reference");
+    if (contains(raw, '>') && raw.contains("]]>"))
+        return raiseError("Unexpected ]]> in character data");
+    m_text = Text(raw, Text::Kind::Content, hasEntities || contains(raw, '\r'));
+    m_tokenType = Characters;
+    return m_tokenType;
+}
+
+NodeSetTokenizer::TokenType NodeSetTokenizer::readStartElement()
+{
+    if (m_openElements.isEmpty() && m_rootSeen)
+        return raiseError("Extra content at the end of the document");
+    m_rootSeen = true;
+
+    ++m_position;
+    QByteArrayView qualifiedName;
+    if (!readName(qualifiedName))
+        return raiseError("Invalid element name");
+
+    while (true) {
+        skipWhitespace();
+        if (m_position >= m_data.size())
+            return raiseError("Unterminated start tag");
+
+        const char c = m_data.at(m_position);
+        if (c == '>') {
+            ++m_position;
+            break;
+        }
+        if (c == '/') {
+            if (m_position + 1 >= m_data.size() || m_data.at(m_position + 1) != '>')
+                return raiseError("Expected '>' after '/'");
+            m_position += 2;
+            m_pendingEndElement = true;
+            break;
+        }
+        if (!isWhitespace(m_data.at(m_position - 1)))
+            return raiseError("Expected whitespace before attribute");
+
+        QByteArrayView attributeName;
+        if (!readName(attributeName))
+            return raiseError("Invalid attribute name");
+        skipWhitespace();
+        if (m_position >= m_data.size() || m_data.at(m_position) != '=')
+            return raiseError("Expected '=' after attribute name");
+        ++m_position;
+        skipWhitespace();
+        if (m_position >= m_data.size())
+            return raiseError("Unterminated start tag");
+        const char quote = m_data.at(m_position);
+        if (quote != '"' && quote != '\'')
+            return raiseError("Expected quoted attribute value");
+        const qsizetype start = m_position + 1;
+        const qsizetype end = find(m_data, start, quote);
+        if (end < 0)
+            return raiseError("Unterminated attribute value");
+        const QByteArrayView raw = m_data.sliced(start, end - start);
+        m_position = end + 1;
+
+        if (contains(raw, '<'))
+            return raiseError("'<' in attribute value");
+        const bool hasEntities = contains(raw, '&');
+        if (hasEntities && !validEntities(raw))
+            return raiseError("Invalid entity reference");
+
+        // namespace declarations are not reported as attributes
+        if (attributeName == "xmlns" || attributeName.startsWith("xmlns:"))
+            continue;
+        for (const Attribute& attribute : std::as_const(m_attributes)) {
+            if (attribute.name() == localName(attributeName))
+                return raiseError("Duplicate attribute");
+        }
+        const bool needsDecoding = hasEntities || contains(raw, '\n') || contains(raw, '\t')
+                                   || contains(raw, '\r');
+        m_attributes.append(Attribute(
+            localName(attributeName), Text(raw, Text::Kind::Attribute, needsDecoding)));
+    }
+
+    m_openElements.append(qualifiedName);
+    m_name = localName(qualifiedName);
+    m_tokenType = StartElement;
+    return m_tokenType;
+}
+
+NodeSetTokenizer::TokenType NodeSetTokenizer::readEndElement()
+{
+    m_position += 2;
+    QByteArrayView qualifiedName;
+    if (!readName(qualifiedName))
+        return raiseError("Invalid element name");
+    skipWhitespace();
+    if (m_position >= m_data.size() || m_data.at(m_position) != '>')
+        return raiseError("Unterminated end tag");
+    ++m_position;
+
+    if (m_openElements.isEmpty() || m_openElements.last() != qualifiedName)
+        return raiseError("Opening and ending tag mismatch");
+    m_openElements.removeLast();
+    m_name = localName(qualifiedName);
+    m_tokenType = EndElement;
+    return m_tokenType;
+}
+
+QString NodeSetTokenizer::readElementText()
+{
+    if (!isStartElement())
+        return QString();
+
+    QString result;
+    while (readNext() != Invalid) {
+        if (isCharacters()) {
+            result += m_text.toString();
+        } else if (isEndElement()) {
+            return result;
+        } else if (isStartElement()) {
+            raiseError("Expected character data");
+            break;
+        }
+    }
+    return QString();
+}
+
+bool NodeSetTokenizer::skipUntil(QByteArrayView terminator)
+{
+    const qsizetype end = m_data.indexOf(terminator, m_position);
+    if (end < 0)
+        return false;
+    m_position = end + terminator.size();
+    return true;
+}
+
+bool NodeSetTokenizer::readName(QByteArrayView& qualifiedName)
+{
+    const qsizetype start = m_position;
+    while (m_position < m_data.size() && !isNameEnd(m_data.at(m_position))) {
+        const char c = m_data.at(m_position);
+        if (c == '<' || c == '"' || c == '\'' || c == '&')
+            return false;
+        ++m_position;
+    }
+    qualifiedName = m_data.sliced(start, m_position - start);
+    return !qualifiedName.isEmpty() && !qualifiedName.startsWith(':')
+           && !qualifiedName.endsWith(':');
+}
+
+void NodeSetTokenizer::skipWhitespace()
+{
+    while (m_position < m_data.size() && isWhitespace(m_data.at(m_position)))
+        ++m_position;
+}
@@ -0,0 +1,124 @@
+// SPDX-FileCopyrightText: 2025 Marius Dege <marius.dege@basyskom.com>
+// SPDX-FileCopyrightText: 2024 Marius Dege <marius.dege@basyskom.com>
+// SPDX-FileCopyrightText: 2024 basysKom GmbH
+
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#ifndef NODESETTOKENIZER_H
+#define NODESETTOKENIZER_H
+
+#include <QAnyStringView>
+#include <QByteArrayView>
+#include <QLatin1StringView>
+#include <QList>
+#include <QString>
+#include <QVarLengthArray>
+
+// Pull tokenizer for the XML subset used by NodeSet2.xml files: elements, attributes, text,
+// comments, CDATA and the predefined and numeric entities. Works directly on the UTF-8 bytes of a
+// mapped file and only decodes text when it is asked for. Tag and quote boundaries are found with
+// memchr, which the C libraries implement with vectorised kernels.
+//
+// It has the subset of the QXmlStreamReader interface the parser uses, so the parser can be
+// instantiated for both. Anything outside the subset (DTDs, other encodings, malformed markup)
+// is an error, the parser then falls back to QXmlStreamReader, which reports it properly.
+class NodeSetTokenizer
+{
+public:
+    enum TokenType { NoToken, Invalid, StartElement, EndElement, Characters, EndDocument };
+
+    // Text or attribute value in the document, decoded on access
+    class Text
+    {
+    public:
+        enum class Kind : quint8 { Content, Attribute, CData };
+
+        Text() = default;
+        Text(QByteArrayView raw, Kind kind, bool needsDecoding)
+            : m_raw(raw)
+            , m_kind(kind)
+            , m_needsDecoding(needsDecoding)
+        {}
+
+        QString toString() const;
+        int toInt() const;
+        bool isEmpty() const { return m_raw.isEmpty(); }
+        bool operator==(QLatin1StringView other) const;
+
+    private:
+        QByteArrayView m_raw;
+        Kind m_kind = Kind::Content;
+        bool m_needsDecoding = false;
+    };
+
+    class Attribute
+    {
+    public:
+        Attribute() = default;
+        Attribute(QByteArrayView name, const Text& value)
+            : m_name(name)
+            , m_value(value)
+        {}
+
+        // local name without the namespace prefix
+        QByteArrayView name() const { return m_name; }
+        Text value() const { return m_value; }
+
+    private:
+        QByteArrayView m_name;
+        Text m_value;
+    };
+
+    class Attributes : public QVarLengthArray<Attribute, 8>
+    {
+    public:
+        Text value(QAnyStringView name) const;
+        bool hasAttribute(QAnyStringView name) const;
+    };
+
+    explicit NodeSetTokenizer(QByteArrayView data);
+
+    // Decodes an attribute value cut from the document like Text::toString. False if it contains
+    // an invalid entity reference.
+    static bool decodeAttributeValue(QByteArrayView raw, QString& value);
+
+    TokenType readNext();
+    TokenType tokenType() const { return m_tokenType; }
+    bool atEnd() const { return m_tokenType == Invalid || m_tokenType == EndDocument; }
+    bool isStartElement() const { return m_tokenType == StartElement; }
+    bool isEndElement() const { return m_tokenType == EndElement; }
+    bool isCharacters() const { return m_tokenType == Characters; }
+
+    QByteArrayView name() const { return m_name; }
+    const Attributes& attributes() const { return m_attributes; }
+    Text text() const { return m_text; }
+    // Reads the text up to the end of the current element, which must not have child elements.
+    QString readElementText();
+
+    bool hasError() const { return m_tokenType == Invalid; }
+    QString errorString() const { return m_errorString; }
+    qsizetype position() const { return m_position; }
+
+private:
+    QByteArrayView m_data;
+    qsizetype m_position = 0;
+    TokenType m_tokenType = NoToken;
+    QByteArrayView m_name;
+    Attributes m_attributes;
+    Text m_text;
+    QString m_errorString;
+    // qualified names of the open elements, to check the end tags
+    QList<QByteArrayView> m_openElements;
+    bool m_pendingEndElement = false;
+    bool m_rootSeen = false;
+
+    TokenType raiseError(const char* message);
+    TokenType readCharacters();
+    TokenType readStartElement();
+    TokenType readEndElement();
+    bool skipUntil(QByteArrayView terminator);
+    bool readName(QByteArrayView& qualifiedName);
+    void skipWhitespace();
+};
+
+#endif // NODESETTOKENIZER_H
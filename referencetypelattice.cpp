@@ -0,0 +1,203 @@
+// SPDX-FileCopyrightText: 2025 Marius Dege <marius.dege@basyskom.com>
+// SPDX-FileCopyrightText: 2024 Marius Dege <marius.dege@basyskom.com>
+// SPDX-FileCopyrightText: 2024 basysKom GmbH
+
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "referencetypelattice.h"
+#include <algorithm>
+#include <iterator>
+#include <QDebug>
+
+namespace {
+
+using Mask = ReferenceTypeLattice::Mask;
+
+const QString UaNamespace = QStringLiteral("http://opcfoundation.org/UA/");
+
+struct StandardTypeInfo
+{
+    quint32 numericId;
+    const char* name;
+    int superType;
+};
+
+// Indexed by StandardType, with the hierarchy of OPC UA Part 5
+constexpr StandardTypeInfo StandardTypes[] = {
+    {31, "References", -1},
+    {33, "HierarchicalReferences", ReferenceTypeLattice::References},
+    {32, "NonHierarchicalReferences", ReferenceTypeLattice::References},
+    {34, "HasChild", ReferenceTypeLattice::HierarchicalReferences},
+    {35, "Organizes", ReferenceTypeLattice::HierarchicalReferences},
+    {44, "Aggregates", ReferenceTypeLattice::HasChild},
+    {47, "HasComponent", ReferenceTypeLattice::Aggregates},
+    {46, "HasProperty", ReferenceTypeLattice::Aggregates},
+    {45, "HasSubtype", ReferenceTypeLattice::HasChild},
+    {37, "HasModellingRule", ReferenceTypeLattice::NonHierarchicalReferences},
+    {40, "HasTypeDefinition", ReferenceTypeLattice::NonHierarchicalReferences},
+    {38, "HasEncoding", ReferenceTypeLattice::NonHierarchicalReferences},
+};
+static_assert(std::size(StandardTypes) == ReferenceTypeLattice::StandardTypeCount);
+
+Mask standardMask(int type)
+{
+    Mask mask;
+    for (; type >= 0; type = StandardTypes[type].superType) {
+        mask |= Mask::bit(type);
+    }
+    return mask;
+}
+
+} // namespace
+
+ReferenceTypeLattice::ReferenceTypeLattice()
+    : ReferenceTypeLattice(QMap<QString, std::shared_ptr<UANodeSet>>())
+{}
+
+ReferenceTypeLattice::ReferenceTypeLattice(
+    const QMap<QString, std::shared_ptr<UANodeSet>>& nodeSets)
+{
+    // Only looked up, a name or URI that is not interned is used by no reference. Such keys get
+    // NoAtom, which typeKey() and the references never produce.
+    AtomTable* atoms = AtomTable::instance();
+    const Atom uaNamespace = atoms->find(UaNamespace);
+    for (int type = 0; type < StandardTypeCount; ++type) {
+        const Mask mask = standardMask(type);
+        m_masks.insert({uaNamespace, UANodeId(0, StandardTypes[type].numericId)}, mask);
+        const Atom name = atoms->find(QString::fromLatin1(StandardTypes[type].name));
+        if (name != AtomTable::NoAtom)
+            m_standardNames.insert(name, mask);
+    }
+
+    // the references of a type may point into any of the nodesets
+    for (const std::shared_ptr<UANodeSet>& nodeSet : nodeSets) {
+        m_namespaceMaps.insert(atoms->find(nodeSet->getNameSpaceUri()), nodeSet->namespaceMap());
+    }
+
+    struct TypeNode
+    {
+        TypeKey key;
+        std::shared_ptr<UANode> node;
+        std::shared_ptr<UANodeSet> nodeSet;
+    };
+    QList<TypeNode> typeNodes;
+    for (const std::shared_ptr<UANodeSet>& nodeSet : nodeSets) {
+        const Atom namespaceUri = atoms->find(nodeSet->getNameSpaceUri());
+        QList<TypeNode> nodes;
+        for (const std::shared_ptr<UANode>& node : nodeSet->referenceTypes()) {
+            const UANodeId nodeId = UANodeId::lookupUtf8(node->nodeIdUtf8());
+            nodes.append({typeKey(namespaceUri, nodeId), node, nodeSet});
+        }
+        // the bits don't depend on the order of the node index
+        std::sort(nodes.begin(), nodes.end(), [](const TypeNode& left, const TypeNode& right) {
+            return left.key.second < right.key.second;
+        });
+        typeNodes.append(nodes);
+    }
+
+    const TypeKey hasSubtype{uaNamespace, UANodeId(0, StandardTypes[HasSubtype].numericId)};
+    QHash<TypeKey, QList<TypeKey>> superTypes;
+    QHash<TypeKey, int> bits;
+    int nextBit = StandardTypeCount;
+    for (const TypeNode& typeNode : std::as_const(typeNodes)) {
+        // the standard types keep their fixed bits, their references may still declare subtypes
+        if (!m_masks.contains(typeNode.key))
+            bits.insert(typeNode.key, nextBit < MaxTypes ? nextBit++ : -1);
+
+        for (const std::shared_ptr<Reference>& reference : typeNode.node->references()) {
+            QString referenceType = typeNode.nodeSet->getNodeIdByAlias(
+                reference->referenceTypeAtom());
+            if (referenceType.isEmpty())
+                referenceType = reference->referenceType();
+            if (typeKey(typeNode.key.first, referenceType) != hasSubtype)
+                continue;
+
+            const TypeKey target{
+                reference->namespaceAtom(),
+                reference->targetId().withoutNamespace()};
+            if (reference->isForward())
+                superTypes[target].append(typeNode.key);
+            else
+                superTypes[typeNode.key].append(target);
+        }
+    }
+    if (nextBit == MaxTypes)
+        qWarning() << "More than" << MaxTypes << "reference types, some only inherit bits";
+
+    QSet<TypeKey> visiting;
+    for (auto it = bits.constBegin(); it != bits.constEnd(); ++it) {
+        computeMask(it.key(), superTypes, bits, visiting);
+    }
+
+    for (const std::shared_ptr<UANodeSet>& nodeSet : nodeSets) {
+        const Atom namespaceUri = atoms->find(nodeSet->getNameSpaceUri());
+        QHash<Atom, Mask>& aliasMasks = m_aliasMasks[namespaceUri];
+        const QMap<QString, QString> aliases = nodeSet->aliasMap();
+        for (const auto [alias, nodeId] : aliases.asKeyValueRange()) {
+            const auto mask = m_masks.constFind(typeKey(namespaceUri, nodeId));
+            const Atom aliasAtom = atoms->find(alias);
+            if (mask != m_masks.constEnd() && aliasAtom != AtomTable::NoAtom)
+                aliasMasks.insert(aliasAtom, *mask);
+        }
+    }
+}
+
+ReferenceTypeLattice::Mask ReferenceTypeLattice::mask(Atom namespaceUri, Atom referenceType) const
+{
+    const auto aliasMasks = m_aliasMasks.constFind(namespaceUri);
+    if (aliasMasks != m_aliasMasks.constEnd()) {
+        const auto mask = aliasMasks->constFind(referenceType);
+        if (mask != aliasMasks->constEnd())
+            return *mask;
+    }
+    const auto standardName = m_standardNames.constFind(referenceType);
+    if (standardName != m_standardNames.constEnd())
+        return *standardName;
+
+    // a NodeId instead of an alias
+    return m_masks.value(typeKey(namespaceUri, AtomTable::instance()->string(referenceType)));
+}
+
+ReferenceTypeLattice::TypeKey ReferenceTypeLattice::typeKey(
+    Atom namespaceUri, const QString& nodeId) const
+{
+    return typeKey(namespaceUri, UANodeId::lookup(nodeId));
+}
+
+ReferenceTypeLattice::TypeKey ReferenceTypeLattice::typeKey(
+    Atom namespaceUri, const UANodeId& id) const
+{
+    if (!id.isValid())
+        return {};
+    const QString uri = id.namespaceIndex() == 0
+                            ? UaNamespace
+                            : m_namespaceMaps.value(namespaceUri).value(id.namespaceIndex());
+    const Atom uriAtom = AtomTable::instance()->find(uri);
+    if (uriAtom == AtomTable::NoAtom)
+        return {};
+    return {uriAtom, id.withoutNamespace()};
+}
+
+ReferenceTypeLattice::Mask ReferenceTypeLattice::computeMask(
+    const TypeKey& key,
+    const QHash<TypeKey, QList<TypeKey>>& superTypes,
+    const QHash<TypeKey, int>& bits,
+    QSet<TypeKey>& visiting)
+{
+    if (const auto mask = m_masks.constFind(key); mask != m_masks.constEnd())
+        return *mask;
+    // unknown supertypes and cycles add nothing
+    const auto bit = bits.constFind(key);
+    if (bit == bits.constEnd() || visiting.contains(key))
+        return Mask();
+
+    visiting.insert(key);
+    Mask mask = *bit >= 0 ? Mask::bit(*bit) : Mask();
+    for (const TypeKey& superType : superTypes.value(key)) {
+        mask |= computeMask(superType, superTypes, bits, visiting);
+    }
+    visiting.remove(key);
+
+    m_masks.insert(key, mask);
+    return mask;
+}
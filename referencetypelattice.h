@@ -0,0 +1,123 @@
+// SPDX-FileCopyrightText: 2025 Marius Dege <marius.dege@basyskom.com>
+// SPDX-FileCopyrightText: 2024 Marius Dege <marius.dege@basyskom.com>
+// SPDX-FileCopyrightText: 2024 basysKom GmbH
+
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#ifndef REFERENCETYPELATTICE_H
+#define REFERENCETYPELATTICE_H
+
+#include "uanodeid.h"
+#include "uanodeset.h"
+#include <QHash>
+#include <QMap>
+#include <QSet>
+#include <utility>
+
+// Subtype hierarchy of the reference types of a set of nodesets. Every reference type has a 128
+// bit mask of itself and all its supertypes, so "is a subtype of" is a single AND, also for
+// reference types defined by a companion spec.
+//
+// The standard reference types the tool tests against have fixed bits and the spec's hierarchy,
+// so they work even without the UA nodeset. The other types get the remaining bits in nodeset
+// order; beyond 128 types a type only has the bits of its supertypes.
+class ReferenceTypeLattice
+{
+public:
+    class Mask
+    {
+    public:
+        constexpr Mask() = default;
+
+        static constexpr Mask bit(int index)
+        {
+            return index < 64 ? Mask(quint64(1) << index, 0)
+                              : Mask(0, quint64(1) << (index - 64));
+        }
+
+        constexpr bool intersects(Mask other) const
+        {
+            return (m_low & other.m_low) | (m_high & other.m_high);
+        }
+        constexpr bool isEmpty() const { return !(m_low | m_high); }
+        constexpr Mask operator|(Mask other) const
+        {
+            return Mask(m_low | other.m_low, m_high | other.m_high);
+        }
+        Mask& operator|=(Mask other)
+        {
+            m_low |= other.m_low;
+            m_high |= other.m_high;
+            return *this;
+        }
+
+    private:
+        constexpr Mask(quint64 low, quint64 high)
+            : m_low(low)
+            , m_high(high)
+        {}
+
+        quint64 m_low = 0;
+        quint64 m_high = 0;
+    };
+
+    static constexpr int MaxTypes = 128;
+
+    // Reference types of the UA namespace with a fixed bit, the value is the bit
+    enum StandardType : quint8 {
+        References,
+        HierarchicalReferences,
+        NonHierarchicalReferences,
+        HasChild,
+        Organizes,
+        Aggregates,
+        HasComponent,
+        HasProperty,
+        HasSubtype,
+        HasModellingRule,
+        HasTypeDefinition,
+        HasEncoding,
+        StandardTypeCount
+    };
+
+    // The bit of the type, to test a mask against
+    static constexpr Mask typeMask(StandardType type) { return Mask::bit(type); }
+
+    // Only knows the standard reference types by their names.
+    ReferenceTypeLattice();
+    // Loads the lazy reference types of the nodesets.
+    explicit ReferenceTypeLattice(const QMap<QString, std::shared_ptr<UANodeSet>>& nodeSets);
+
+    // Mask of a ReferenceType attribute, an alias or a NodeId, as written in the nodeset with
+    // the namespace URI. Empty if the type is unknown.
+    Mask mask(Atom namespaceUri, Atom referenceType) const;
+    bool isSubtypeOf(Atom namespaceUri, Atom referenceType, StandardType superType) const
+    {
+        return mask(namespaceUri, referenceType).intersects(typeMask(superType));
+    }
+
+    // number of reference types with a mask
+    qsizetype size() const { return m_masks.size(); }
+
+private:
+    // namespace URI and NodeId without namespace of a reference type
+    using TypeKey = std::pair<Atom, UANodeId>;
+
+    QHash<TypeKey, Mask> m_masks;
+    // masks of the aliases of every nodeset, by its namespace URI
+    QHash<Atom, QHash<Atom, Mask>> m_aliasMasks;
+    // the browse names of the standard types, for references outside of the nodesets
+    QHash<Atom, Mask> m_standardNames;
+    QHash<Atom, QMap<int, QString>> m_namespaceMaps;
+
+    TypeKey typeKey(Atom namespaceUri, const QString& nodeId) const;
+    TypeKey typeKey(Atom namespaceUri, const UANodeId& id) const;
+    // bit -1 for a type without an own bit
+    Mask computeMask(
+        const TypeKey& key,
+        const QHash<TypeKey, QList<TypeKey>>& superTypes,
+        const QHash<TypeKey, int>& bits,
+        QSet<TypeKey>& visiting);
+};
+
+#endif // REFERENCETYPELATTICE_H
@@ -12,8 +12,8 @@ TreeItem::TreeItem(std::shared_ptr<UANode> node, std::shared_ptr<TreeItem> paren
     , m_parentItem(parentItem)
 {
     if (m_parentItem.lock() != nullptr && m_parentItem.lock()->getNode() != nullptr) {
-        m_node->setParentNode(m_parentItem.lock()->getNode());
-        m_node->setParentNodeId(m_parentItem.lock()->nodeId());
+        m_parentNode = m_parentItem.lock()->getNode();
+        m_parentNodeId = m_parentItem.lock()->nodeIdUtf8().toByteArray();
     }
 }
 
@@ -82,35 +82,64 @@ std::shared_ptr<UANode> TreeItem::getNode() const
     return m_node;
 }
 
+std::shared_ptr<UANode> TreeItem::sourceNode() const
+{
+    return m_sourceNode ? m_sourceNode : m_node;
+}
+
+UANode* TreeItem::detachNode()
+{
+    if (!m_sourceNode) {
+        m_sourceNode = m_node;
+        m_node = m_node->clone();
+    }
+    return m_node.get();
+}
+
 QString TreeItem::nodeId() const
 {
-    return m_node->nodeId();
+    return m_nodeId ? QString::fromUtf8(*m_nodeId) : m_node->nodeId();
+}
+
+QByteArrayView TreeItem::nodeIdUtf8() const
+{
+    return m_nodeId ? QByteArrayView(*m_nodeId) : m_node->nodeIdUtf8();
 }
 
 void TreeItem::setNodeId(const QString& newNodeId)
 {
-    if (m_node->nodeId() == newNodeId)
+    if (nodeId() == newNodeId)
         return;
-    m_node->setNodeId(newNodeId);
+    m_nodeId = newNodeId.toUtf8();
     emit nodeIdChanged();
 }
 
+void TreeItem::changeNamespaceId(const int newNamespaceId)
+{
+    setNodeId(UANode::nodeIdWithNamespaceId(nodeId(), newNamespaceId));
+}
+
 QString TreeItem::parentNodeId() const
 {
-    return m_node->parentNodeId();
+    return m_parentNodeId ? QString::fromUtf8(*m_parentNodeId) : m_node->parentNodeId();
+}
+
+QByteArrayView TreeItem::parentNodeIdUtf8() const
+{
+    return m_parentNodeId ? QByteArrayView(*m_parentNodeId) : m_node->parentNodeIdUtf8();
 }
 
 void TreeItem::setParentNodeId(const QString& newParentNodeId)
 {
-    if (m_node->parentNodeId() == newParentNodeId)
+    if (parentNodeId() == newParentNodeId)
         return;
-    m_node->setParentNodeId(newParentNodeId);
+    m_parentNodeId = newParentNodeId.toUtf8();
     emit parentNodeIdChanged();
 }
 
 QString TreeItem::browseName() const
 {
-    return m_node->browseName();
+    return m_browseName ? QString::fromUtf8(*m_browseName) : m_node->browseName();
 }
 
 QString TreeItem::baseBrowseName() const
@@ -118,72 +147,95 @@ QString TreeItem::baseBrowseName() const
     return m_node->baseBrowseName();
 }
 
+QByteArrayView TreeItem::browseNameUtf8() const
+{
+    return m_browseName ? QByteArrayView(*m_browseName) : m_node->browseNameUtf8();
+}
+
 void TreeItem::setBrowseName(const QString& newBrowseName)
 {
-    if (m_node->browseName() == newBrowseName)
+    if (browseName() == newBrowseName)
         return;
-    m_node->setBrowseName(newBrowseName);
+    m_browseName = newBrowseName.toUtf8();
+    m_nodeVariableName = UANode::nodeVariableName(newBrowseName, nodeId()).toUtf8();
     emit browseNameChanged();
+    emit nodeVariableNameChanged();
 }
 
 QString TreeItem::displayName() const
 {
-    return m_node->displayName();
+    return m_displayName ? QString::fromUtf8(*m_displayName) : m_node->displayName();
+}
+
+QByteArrayView TreeItem::displayNameUtf8() const
+{
+    return m_displayName ? QByteArrayView(*m_displayName) : m_node->displayNameUtf8();
 }
 
 void TreeItem::setDisplayName(const QString& newDisplayName)
 {
-    if (m_node->displayName() == newDisplayName)
+    if (displayName() == newDisplayName)
         return;
-    m_node->setDisplayName(newDisplayName);
+    m_displayName = newDisplayName.toUtf8();
     emit displayNameChanged();
 }
 
-QList<std::shared_ptr<Reference>> TreeItem::references() const
+const QList<std::shared_ptr<Reference>>& TreeItem::references() const
 {
     return m_node->references();
 }
 
 QString TreeItem::description() const
 {
-    return m_node->description();
+    return m_description ? QString::fromUtf8(*m_description) : m_node->description();
+}
+
+QByteArrayView TreeItem::descriptionUtf8() const
+{
+    return m_description ? QByteArrayView(*m_description) : m_node->descriptionUtf8();
 }
 
 void TreeItem::setDescription(const QString& newDescription)
 {
-    if (m_node->description() == newDescription)
+    if (description() == newDescription)
         return;
-    m_node->setDescription(newDescription);
+    m_description = newDescription.toUtf8();
     emit descriptionChanged();
 }
 
 std::weak_ptr<UANode> TreeItem::parentNode() const
 {
-    return m_node->parentNode();
+    return m_parentNode ? *m_parentNode : m_node->parentNode();
 }
 
 void TreeItem::setParentNode(std::weak_ptr<UANode> newParentNode)
 {
-    auto currentParent = m_node->parentNode().lock();
+    auto currentParent = parentNode().lock();
     auto newParent = newParentNode.lock();
 
     if (currentParent == newParent)
         return;
 
-    m_node->setParentNode(newParentNode);
+    m_parentNode = newParentNode;
     emit parentNodeChanged();
 }
 
 QString TreeItem::namespaceString() const
 {
-    return m_node->namespaceString();
+    return m_namespaceString ? AtomTable::instance()->string(*m_namespaceString)
+                             : m_node->namespaceString();
+}
+
+Atom TreeItem::namespaceAtom() const
+{
+    return m_namespaceString.value_or(m_node->namespaceAtom());
 }
 
 void TreeItem::setNamespaceString(const QString& newNamespaceString)
 {
-    if (m_node->namespaceString() == newNamespaceString)
+    if (namespaceString() == newNamespaceString)
         return;
-    m_node->setNamespaceString(newNamespaceString);
+    m_namespaceString = AtomTable::instance()->intern(newNamespaceString);
     emit namespaceStringChanged();
 }
 
@@ -204,7 +256,7 @@ void TreeItem::setDefinitionName(const QString& newDefinitionName)
     if (UADataType* dataType = dynamic_cast<UADataType*>(m_node.get())) {
         if (dataType->definitionName() == newDefinitionName)
             return;
-        dataType->setDefinitionName(newDefinitionName);
+        static_cast<UADataType*>(detachNode())->setDefinitionName(newDefinitionName);
         emit definitionNameChanged();
     }
 }
@@ -228,8 +280,10 @@ QVariantList TreeItem::definitionFields() const
     return QVariantList();
 }
 
-UADataType TreeItem::dataType() const
+const UADataType& TreeItem::dataType() const
 {
+    static const UADataType noDataType;
+
     // only UAVariable and UAVariableType have a dataType member.
     if (const UAVariable* variable = dynamic_cast<const UAVariable*>(m_node.get()))
         return variable->dataType();
@@ -237,7 +291,7 @@ UADataType TreeItem::dataType() const
         return variableType->dataType();
 
     qWarning() << "Access to non existing UADataType member from " << m_node->typeName();
-    return UADataType();
+    return noDataType;
 }
 
 void TreeItem::setDataType(const UADataType& newDataType)
@@ -245,12 +299,11 @@ void TreeItem::setDataType(const UADataType& newDataType)
     if (UAVariable* variable = dynamic_cast<UAVariable*>(m_node.get())) {
         if (variable->dataType() == newDataType)
             return;
-        variable->setDataType(newDataType);
-    }
-    if (UAVariableType* variableType = dynamic_cast<UAVariableType*>(m_node.get())) {
+        static_cast<UAVariable*>(detachNode())->setDataType(newDataType);
+    } else if (UAVariableType* variableType = dynamic_cast<UAVariableType*>(m_node.get())) {
         if (variableType->dataType() == newDataType)
             return;
-        variableType->setDataType(newDataType);
+        static_cast<UAVariableType*>(detachNode())->setDataType(newDataType);
     } else {
         qWarning() << "Access to non existing UADataType member from " << m_node->typeName();
         return;
@@ -275,12 +328,11 @@ void TreeItem::setIsAbstract(bool newIsAbstract)
     if (UAVariableType* variableType = dynamic_cast<UAVariableType*>(m_node.get())) {
         if (variableType->isAbstract() == newIsAbstract)
             return;
-        variableType->setIsAbstract(newIsAbstract);
-    }
-    if (UAObjectType* objectType = dynamic_cast<UAObjectType*>(m_node.get())) {
+        static_cast<UAVariableType*>(detachNode())->setIsAbstract(newIsAbstract);
+    } else if (UAObjectType* objectType = dynamic_cast<UAObjectType*>(m_node.get())) {
         if (objectType->isAbstract() == newIsAbstract)
             return;
-        objectType->setIsAbstract(newIsAbstract);
+        static_cast<UAObjectType*>(detachNode())->setIsAbstract(newIsAbstract);
     } else {
         qWarning() << "Access to non existing UADataType member from " << m_node->typeName();
         return;
@@ -377,14 +429,14 @@ void TreeItem::setReferenceNode(UANode* newNode)
 
 bool TreeItem::isOptional() const
 {
-    return m_node->isOptional();
+    return m_isOptional.value_or(m_node->isOptional());
 }
 
 void TreeItem::setIsOptional(bool newIsOptional)
 {
-    if (m_node->isOptional() == newIsOptional)
+    if (isOptional() == newIsOptional)
         return;
-    m_node->setIsOptional(newIsOptional);
+    m_isOptional = newIsOptional;
     emit isOptionalChanged();
 }
 
@@ -411,14 +463,14 @@ QStringList TreeItem::userInputMask() const
 
 bool TreeItem::isRootNode() const
 {
-    return m_node->isRootNode();
+    return m_isRootNode.value_or(m_node->isRootNode());
 }
 
 void TreeItem::setIsRootNode(bool newIsRootNode)
 {
-    if (m_node->isRootNode() == newIsRootNode)
+    if (isRootNode() == newIsRootNode)
         return;
-    m_node->setIsRootNode(newIsRootNode);
+    m_isRootNode = newIsRootNode;
     emit isRootNodeChanged();
 }
 
@@ -453,7 +505,14 @@ void TreeItem::setSelected(bool newIsSelected)
 
 QString TreeItem::nodeVariableName() const
 {
-    return m_node->nodeVariableName();
+    return m_nodeVariableName ? QString::fromUtf8(*m_nodeVariableName)
+                              : m_node->nodeVariableName();
+}
+
+QByteArrayView TreeItem::nodeVariableNameUtf8() const
+{
+    return m_nodeVariableName ? QByteArrayView(*m_nodeVariableName)
+                              : m_node->nodeVariableNameUtf8();
 }
 
 bool TreeItem::isParentSelected() const
@@ -477,13 +536,20 @@ void TreeItem::setIsParentSelected(bool newIsParentSelected)
 
 QString TreeItem::uniqueBaseBrowseName() const
 {
-    return m_node->uniqueBaseBrowseName();
+    return m_uniqueBaseBrowseName ? QString::fromUtf8(*m_uniqueBaseBrowseName)
+                                  : m_node->uniqueBaseBrowseName();
+}
+
+QByteArrayView TreeItem::uniqueBaseBrowseNameUtf8() const
+{
+    return m_uniqueBaseBrowseName ? QByteArrayView(*m_uniqueBaseBrowseName)
+                                  : m_node->uniqueBaseBrowseNameUtf8();
 }
 
 void TreeItem::setUniqueBaseBrowseName(const QString& newUniqueBaseBrowseName)
 {
-    if (m_node->uniqueBaseBrowseName() == newUniqueBaseBrowseName)
+    if (uniqueBaseBrowseName() == newUniqueBaseBrowseName)
         return;
-    m_node->setUniqueBaseBrowseName(newUniqueBaseBrowseName);
+    m_uniqueBaseBrowseName = newUniqueBaseBrowseName.toUtf8();
     emit uniqueBaseBrowseNameChanged();
 }
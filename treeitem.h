@@ -12,6 +12,8 @@
 #include <QObject>
 #include <QVariant>
 
+#include <optional>
+
 class TreeItem : public QObject, public std::enable_shared_from_this<TreeItem>
 {
     Q_OBJECT
@@ -76,31 +78,45 @@ public:
     Q_INVOKABLE QVariant getValue(const QString valueRole);
 
     std::shared_ptr<TreeItem> parentItem();
+    // Node of the loaded nodesets, shared with every other item of the same instance declaration,
+    // or the item's own copy of it once a setter needed one
     std::shared_ptr<UANode> getNode() const;
+    // The node of the loaded nodesets the item was created from, also after it was copied. This is
+    // the node the NodeGraph knows.
+    std::shared_ptr<UANode> sourceNode() const;
 
+    // The QString getters are for QML and TreeModel::data, the *Utf8 views and the atom for the
+    // model internals. Views are valid until the item or its node is changed.
     QString nodeId() const;
+    QByteArrayView nodeIdUtf8() const;
     void setNodeId(const QString& newNodeId);
+    void changeNamespaceId(const int newNamespaceId);
 
     QString parentNodeId() const;
+    QByteArrayView parentNodeIdUtf8() const;
     void setParentNodeId(const QString& newParentNodeId);
 
     QString browseName() const;
+    QByteArrayView browseNameUtf8() const;
     void setBrowseName(const QString& newBrowseName);
 
     QString baseBrowseName() const;
 
     QString displayName() const;
+    QByteArrayView displayNameUtf8() const;
     void setDisplayName(const QString& newDisplayName);
 
-    QList<std::shared_ptr<Reference>> references() const;
+    const QList<std::shared_ptr<Reference>>& references() const;
 
     QString description() const;
+    QByteArrayView descriptionUtf8() const;
     void setDescription(const QString& newDescription);
 
     std::weak_ptr<UANode> parentNode() const;
     void setParentNode(std::weak_ptr<UANode> newParentNode);
 
     QString namespaceString() const;
+    Atom namespaceAtom() const;
     void setNamespaceString(const QString& newNamespaceString);
 
     QString definitionName() const;
@@ -108,7 +124,7 @@ public:
 
     QVariantList definitionFields() const;
 
-    UADataType dataType() const;
+    const UADataType& dataType() const;
     void setDataType(const UADataType& newDataType);
 
     bool isAbstract() const;
@@ -148,11 +164,13 @@ public:
     void setValueModelIndex(int newValueModelIndex);
 
     QString nodeVariableName() const;
+    QByteArrayView nodeVariableNameUtf8() const;
 
     bool isParentSelected() const;
     void setIsParentSelected(bool newIsParentSelected);
 
     QString uniqueBaseBrowseName() const;
+    QByteArrayView uniqueBaseBrowseNameUtf8() const;
     void setUniqueBaseBrowseName(const QString& newUniqueBaseBrowseName);
 
 signals:
@@ -189,12 +207,30 @@ private:
     QList<std::shared_ptr<TreeItem>> m_childItems;
     std::shared_ptr<UANode> m_node;
     std::weak_ptr<TreeItem> m_parentItem;
+
+    // Values of this item that differ from the shared node, unset ones are read from the node.
+    // Setters for members that only the node has give the item its own copy first.
+    std::optional<QByteArray> m_nodeId;
+    std::optional<QByteArray> m_browseName;
+    std::optional<QByteArray> m_nodeVariableName;
+    std::optional<QByteArray> m_displayName;
+    std::optional<QByteArray> m_description;
+    std::optional<QByteArray> m_parentNodeId;
+    std::optional<QByteArray> m_uniqueBaseBrowseName;
+    std::optional<Atom> m_namespaceString;
+    std::optional<std::weak_ptr<UANode>> m_parentNode;
+    std::optional<bool> m_isOptional;
+    std::optional<bool> m_isRootNode;
+    // the shared node m_node was copied from, null as long as the item has no copy of its own
+    std::shared_ptr<UANode> m_sourceNode;
+
     QStringList m_userInputMask;
     QMap<QString, QVariant> m_valueMap;
 
     bool m_isSelected = false;
     bool m_isParentSelected = false;
     void updateChildrenSelected(bool selected);
+    UANode* detachNode();
 };
 
 Q_DECLARE_METATYPE(TreeItem)
@@ -291,19 +291,20 @@ std::shared_ptr<TreeItem> TreeModel::rootItem() const
 
 std::shared_ptr<TreeItem> TreeModel::getItemByName(const QString& name) const
 {
-    auto found = findItemByBrowseNameRecursive(m_rootItem, name);
+    auto found = findItemByBrowseNameRecursive(m_rootItem, name.toUtf8());
     return found;
 }
 
 bool TreeModel::isBrowseNameUnique(const QString& name) const
 {
-    return findBrowseNameRecursive(m_rootItem, name) == QStringLiteral("");
+    return findBrowseNameRecursive(m_rootItem, name.toUtf8()) == QStringLiteral("");
 }
 
-QString TreeModel::findBrowseNameRecursive(std::shared_ptr<TreeItem> parent, const QString& name) const
+QString TreeModel::findBrowseNameRecursive(
+    std::shared_ptr<TreeItem> parent, QByteArrayView name) const
 {
     if (parent->getNode() != nullptr)
-        if (parent->browseName() == name)
+        if (parent->browseNameUtf8() == name)
             return parent->browseName();
 
     for (int i = 0; i < parent->childCount(); ++i) {
@@ -318,10 +319,10 @@ QString TreeModel::findBrowseNameRecursive(std::shared_ptr<TreeItem> parent, con
 }
 
 std::shared_ptr<TreeItem> TreeModel::findItemByBrowseNameRecursive(
-    std::shared_ptr<TreeItem> parent, const QString& name) const
+    std::shared_ptr<TreeItem> parent, QByteArrayView name) const
 {
     if (parent->getNode() != nullptr)
-        if (parent->getNode()->browseName() == name)
+        if (parent->browseNameUtf8() == name)
             return parent;
 
     for (int i = 0; i < parent->childCount(); ++i) {
@@ -390,32 +391,22 @@ void TreeModel::addRootNode(
     bool useUniqueBrowseNames,
     bool safeOriginalBrowseName)
 {
+    std::shared_ptr<TreeItem> rootItem = std::make_shared<TreeItem>(node, m_rootItem);
     if (useUniqueBrowseNames) {
-        node->setBrowseName(makeBrowseNameUnique(node->browseName()));
+        rootItem->setBrowseName(makeBrowseNameUnique(node->browseName()));
         if (safeOriginalBrowseName)
-            node->setUniqueBaseBrowseName(node->browseName());
+            rootItem->setUniqueBaseBrowseName(rootItem->browseName());
     }
-    node->setIsRootNode(true);
-    std::shared_ptr<TreeItem> rootItem = std::make_shared<TreeItem>(node, m_rootItem);
+    rootItem->setIsRootNode(true);
     connect(rootItem.get(), &TreeItem::forceUpdate, this, &TreeModel::onForceUpdate);
 
     m_rootItem->appendChild(rootItem);
     addChildNodes(rootItem, useUniqueBrowseNames, safeOriginalBrowseName);
 
-    // Collect and add inherited nodes
-    QSet<std::shared_ptr<UANode>> inheritedNodes;
-    collectInheritedNodes(node, inheritedNodes);
-
-    for (const std::shared_ptr<UANode>& inheritedNode : std::as_const(inheritedNodes)) {
-        if (!inheritedNode)
-            continue;
-        for (const auto& reference : inheritedNode->references()) {
-            // FIXME we should allow to generate optional nodes but then there are duplicates...
-            if (isValidChildNode(reference) /* && !reference->node()->isOptional()*/) {
-                addNodeToTree(
-                    rootItem, reference->node(), useUniqueBrowseNames, safeOriginalBrowseName);
-            }
-        }
+    // Add the members inherited from the supertypes
+    for (const std::shared_ptr<UANode>& member : nodeGraph()->inheritedMembers(node)) {
+        // FIXME we should allow to generate optional nodes but then there are duplicates...
+        addNodeToTree(rootItem, member, useUniqueBrowseNames, safeOriginalBrowseName);
     }
 
     if (resolveSelection) {
@@ -441,6 +432,18 @@ void TreeModel::removeRootNodeFromSelection(const int index)
     }
 }
 
+void TreeModel::setNodeGraph(std::shared_ptr<NodeGraph> nodeGraph)
+{
+    m_nodeGraph = std::move(nodeGraph);
+}
+
+std::shared_ptr<NodeGraph> TreeModel::nodeGraph()
+{
+    if (!m_nodeGraph)
+        m_nodeGraph = std::make_shared<NodeGraph>();
+    return m_nodeGraph;
+}
+
 void TreeModel::resetModel()
 {
     beginResetModel();
@@ -451,73 +454,40 @@ void TreeModel::resetModel()
     endResetModel();
 }
 
-void TreeModel::collectInheritedNodes(
-    std::shared_ptr<UANode> node, QSet<std::shared_ptr<UANode>>& nodes)
-{
-    if (!node)
-        return;
-
-    for (const auto& reference : node->references()) {
-        if (shouldAddInheritedNode(reference)) {
-            std::shared_ptr<UANode> refNode = reference->node();
-            if (!nodes.contains(refNode)) {
-                nodes.insert(refNode);
-                collectInheritedNodes(refNode, nodes);
-            }
-        }
-    }
-}
-
 void TreeModel::addChildNodes(
     std::shared_ptr<TreeItem> parent, bool useUniqueBrowseNames, bool safeOriginalBrowseName)
 {
     if (!parent)
         return;
-    auto node = parent->getNode();
+    // the node of the nodeset, the graph does not know the copies of edited items
+    auto node = parent->sourceNode();
     if (!node)
         return;
 
-    static QSet<QString> visitedNodes;
-    QString nodeId = node->nodeId();
+    // items share the nodes of the nodesets, a node on the current path is a cycle
+    static QSet<const UANode*> visitedNodes;
+    const UANode* visited = node.get();
 
-    if (visitedNodes.contains(nodeId))
+    if (visitedNodes.contains(visited))
         return;
 
-    visitedNodes.insert(nodeId);
+    visitedNodes.insert(visited);
 
-    for (const auto& reference : node->references()) {
-        if (isValidChildNode(reference) && reference->isForward()) {
-            addNodeToTree(parent, reference->node(), useUniqueBrowseNames, safeOriginalBrowseName);
+    const std::shared_ptr<NodeGraph> graph = nodeGraph();
+    const qint32 index = graph->indexOf(node.get());
+    for (const NodeGraph::Edge& edge : graph->edges(index, NodeGraph::Direction::Forward)) {
+        if (isValidChildNode(edge)) {
+            addNodeToTree(
+                parent, graph->node(edge.target), useUniqueBrowseNames, safeOriginalBrowseName);
         }
     }
 
-    visitedNodes.remove(nodeId);
+    visitedNodes.remove(visited);
 }
 
-bool TreeModel::isValidChildNode(const std::shared_ptr<Reference> reference) const
+bool TreeModel::isValidChildNode(const NodeGraph::Edge& edge)
 {
-    if (!reference->node())
-        return false;
-    const QString& typeName = reference->node()->typeName();
-    if (typeName != XmlTags::UAObject && typeName != XmlTags::UAMethod
-        && typeName != XmlTags::UAVariable)
-        return false;
-
-    const QString& browseName = reference->node()->browseName();
-    if (browseName.contains(XmlTags::Mandatory) || browseName.contains(XmlTags::Optional)
-        || browseName.contains(XmlTags::Arguments))
-        return false;
-
-    return true;
-}
-
-bool TreeModel::shouldAddInheritedNode(const std::shared_ptr<Reference> reference) const
-{
-    if (reference->isForward())
-        return false;
-
-    const QString& refType = reference->referenceType();
-    return (refType == XmlTags::HasSubtype || refType == XmlTags::HasTypeDefinition);
+    return nodeGraph()->isInstanceDeclaration(edge);
 }
 
 void TreeModel::addNodeToTree(
@@ -529,19 +499,19 @@ void TreeModel::addNodeToTree(
     if (!parentItem || !childNode)
         return;
 
-    auto childNodeCopy = childNode->clone();
+    // The item shares the node of the nodeset and only keeps the values it changes
+    std::shared_ptr<TreeItem> childItem = std::make_shared<TreeItem>(childNode, parentItem);
     if (useUniqueBrowseNames)
-        childNodeCopy->setBrowseName(makeBrowseNameUnique(childNodeCopy->browseName()));
+        childItem->setBrowseName(makeBrowseNameUnique(childNode->browseName()));
     if (safeOriginalBrowseName)
-        childNodeCopy->setUniqueBaseBrowseName(childNodeCopy->browseName());
+        childItem->setUniqueBaseBrowseName(childItem->browseName());
 
-    auto parentNamespaceMap = Utils::instance()->currentNameSpaceMaps().value(
-        parentItem->namespaceString());
-    if (parentItem->namespaceString() != childNodeCopy->namespaceString()) {
-        childNodeCopy->changeNamespaceId(parentNamespaceMap.key(childNodeCopy->namespaceString()));
+    if (parentItem->namespaceAtom() != childNode->namespaceAtom()) {
+        auto parentNamespaceMap = Utils::instance()->currentNameSpaceMaps().value(
+            parentItem->namespaceString());
+        childItem->changeNamespaceId(parentNamespaceMap.key(childNode->namespaceString()));
     }
 
-    std::shared_ptr<TreeItem> childItem = std::make_shared<TreeItem>(childNodeCopy, parentItem);
     connect(childItem.get(), &TreeItem::forceUpdate, this, &TreeModel::onForceUpdate);
 
     parentItem->appendChild(childItem);
@@ -8,6 +8,7 @@
 #ifndef TREEMODEL_H
 #define TREEMODEL_H
 
+#include "nodegraph.h"
 #include "treeitem.h"
 #include "uanodeset.h"
 #include <QAbstractItemModel>
@@ -68,6 +69,10 @@ public:
     void removeRootNodeFromSelection(const int index);
     void resetModel();
 
+    // Shared by the models of the same nodesets, so the type hierarchy is only walked once
+    void setNodeGraph(std::shared_ptr<NodeGraph> nodeGraph);
+    std::shared_ptr<NodeGraph> nodeGraph();
+
     Q_INVOKABLE std::shared_ptr<TreeItem> getCurrentItem() const;
     Q_INVOKABLE void setCurrentItem(int indexInteger);
     Q_INVOKABLE std::shared_ptr<TreeItem> getItemByName(const QString& name) const;
@@ -92,22 +97,21 @@ private slots:
 private:
     std::shared_ptr<TreeItem> m_rootItem;
     std::shared_ptr<TreeItem> m_currentItem;
+    std::shared_ptr<NodeGraph> m_nodeGraph;
 
     void addChildNodes(
         std::shared_ptr<TreeItem> parent,
         bool useUniqueBrowseNames = false,
         bool safeOriginalBrowseName = false);
-    void collectInheritedNodes(std::shared_ptr<UANode> node, QSet<std::shared_ptr<UANode>>& nodes);
-    bool isValidChildNode(const std::shared_ptr<Reference> reference) const;
+    bool isValidChildNode(const NodeGraph::Edge& edge);
     void addNodeToTree(
         std::shared_ptr<TreeItem> parentItem,
         std::shared_ptr<UANode> childNode,
         bool useUniqueBrowseNames = false,
         bool safeOriginalBrowseName = false);
-    bool shouldAddInheritedNode(const std::shared_ptr<Reference> reference) const;
     std::shared_ptr<TreeItem> findItemByBrowseNameRecursive(
-        std::shared_ptr<TreeItem> parent, const QString& name) const;
-    QString findBrowseNameRecursive(std::shared_ptr<TreeItem> parent, const QString& name) const;
+        std::shared_ptr<TreeItem> parent, QByteArrayView name) const;
+    QString findBrowseNameRecursive(std::shared_ptr<TreeItem> parent, QByteArrayView name) const;
     void setItemSelected(TreeItem* item, bool selected, bool emitSignal = false);
     void setItemSelectedRecursive(TreeItem* item, bool selected, bool emitSignal);
     void emitDataChangedRecursive(const QModelIndex& parentIndex);
@@ -60,37 +60,52 @@ UANode& UANode::operator=(const UANode& other)
 }
 
 QString UANode::nodeId() const
+{
+    return QString::fromUtf8(m_nodeId);
+}
+
+QByteArrayView UANode::nodeIdUtf8() const
 {
     return m_nodeId;
 }
 
 void UANode::setNodeId(const QString& nodeId)
 {
-    m_nodeId = nodeId;
+    m_nodeId = nodeId.toUtf8();
 }
 
 QString UANode::browseName() const
+{
+    return QString::fromUtf8(m_browseName);
+}
+
+QByteArrayView UANode::browseNameUtf8() const
 {
     return m_browseName;
 }
 
 void UANode::setBrowseName(const QString& browseName)
 {
-    m_browseName = browseName;
+    m_browseName = browseName.toUtf8();
     setNodeVariableName();
 }
 
 QString UANode::displayName() const
+{
+    return QString::fromUtf8(m_displayName);
+}
+
+QByteArrayView UANode::displayNameUtf8() const
 {
     return m_displayName;
 }
 
 void UANode::setDisplayName(const QString& displayName)
 {
-    m_displayName = displayName;
+    m_displayName = displayName.toUtf8();
 }
 
-QList<std::shared_ptr<Reference>> UANode::references() const
+const QList<std::shared_ptr<Reference>>& UANode::references() const
 {
     return m_references;
 }
@@ -100,24 +115,39 @@ void UANode::addReference(std::shared_ptr<Reference> reference)
     m_references.append(std::move(reference));
 }
 
+void UANode::clearReferences()
+{
+    m_references.clear();
+}
+
 QString UANode::parentNodeId() const
+{
+    return QString::fromUtf8(m_parentNodeId);
+}
+
+QByteArrayView UANode::parentNodeIdUtf8() const
 {
     return m_parentNodeId;
 }
 
 void UANode::setParentNodeId(const QString& parentNodeId)
 {
-    m_parentNodeId = parentNodeId;
+    m_parentNodeId = parentNodeId.toUtf8();
 }
 
 QString UANode::description() const
+{
+    return QString::fromUtf8(m_description);
+}
+
+QByteArrayView UANode::descriptionUtf8() const
 {
     return m_description;
 }
 
 void UANode::setDescription(const QString& description)
 {
-    m_description = description;
+    m_description = description.toUtf8();
 }
 
 std::weak_ptr<UANode> UANode::parentNode() const
@@ -131,13 +161,35 @@ void UANode::setParentNode(std::weak_ptr<UANode> parentNode)
 }
 
 QString UANode::namespaceString() const
+{
+    return AtomTable::instance()->string(m_namespaceString);
+}
+
+Atom UANode::namespaceAtom() const
 {
     return m_namespaceString;
 }
 
 void UANode::setNamespaceString(const QString& newNamespaceString)
 {
-    m_namespaceString = newNamespaceString;
+    m_namespaceString = AtomTable::instance()->intern(newNamespaceString);
+}
+
+void UANode::setNamespaceAtom(Atom namespaceAtom)
+{
+    m_namespaceString = namespaceAtom;
+}
+
+void UANode::setUtf8Strings(Utf8Strings&& strings)
+{
+    m_nodeId = std::move(strings.nodeId);
+    m_browseName = std::move(strings.browseName);
+    m_baseBrowseName = std::move(strings.baseBrowseName);
+    m_uniqueBaseBrowseName = std::move(strings.uniqueBaseBrowseName);
+    m_displayName = std::move(strings.displayName);
+    m_nodeVariableName = std::move(strings.nodeVariableName);
+    m_description = std::move(strings.description);
+    m_parentNodeId = std::move(strings.parentNodeId);
 }
 
 bool UANode::isOptional() const
@@ -152,19 +204,24 @@ void UANode::setIsOptional(bool newIsOptional)
 
 void UANode::changeNamespaceId(const int newNamespaceId)
 {
-    int nsPosition = m_nodeId.indexOf(QStringLiteral("ns="));
+    m_nodeId = nodeIdWithNamespaceId(nodeId(), newNamespaceId).toUtf8();
+}
+
+QString UANode::nodeIdWithNamespaceId(const QString& nodeId, const int newNamespaceId)
+{
+    QString result = nodeId;
+    const qsizetype nsPosition = result.indexOf(QStringLiteral("ns="));
     if (nsPosition != -1) {
-        int semicolonPosition = m_nodeId.indexOf(QStringLiteral(";"), nsPosition);
+        const qsizetype semicolonPosition = result.indexOf(u';', nsPosition);
         if (semicolonPosition != -1) {
             // Replace the namespace number with the new one
-            QString newNodeId = m_nodeId.replace(
+            result.replace(
                 nsPosition + 3,
                 semicolonPosition - (nsPosition + 3),
                 QString::number(newNamespaceId));
-            // Set the new NodeId
-            setNodeId(newNodeId);
         }
     }
+    return result;
 }
 
 bool UANode::isRootNode() const
@@ -178,37 +235,54 @@ void UANode::setIsRootNode(bool newIsRootNode)
 }
 
 QString UANode::nodeVariableName() const
+{
+    return QString::fromUtf8(m_nodeVariableName);
+}
+
+QByteArrayView UANode::nodeVariableNameUtf8() const
 {
     return m_nodeVariableName;
 }
 
 void UANode::setNodeVariableName()
 {
-    QString variableNameStr = Utils::instance()->removeNamespaceIndexFromName(m_browseName)
-                              + QStringLiteral("_")
-                              + Utils::instance()->extractIdentifier(m_nodeId);
+    m_nodeVariableName = nodeVariableName(browseName(), nodeId()).toUtf8();
+}
 
-    m_nodeVariableName = variableNameStr;
+QString UANode::nodeVariableName(const QString& browseName, const QString& nodeId)
+{
+    return Utils::instance()->removeNamespaceIndexFromName(browseName) + QStringLiteral("_")
+           + Utils::instance()->extractIdentifier(nodeId);
 }
 
 QString UANode::baseBrowseName() const
+{
+    return QString::fromUtf8(m_baseBrowseName);
+}
+
+QByteArrayView UANode::baseBrowseNameUtf8() const
 {
     return m_baseBrowseName;
 }
 
 void UANode::setBaseBrowseName(const QString& newBaseBrowseName)
 {
-    m_baseBrowseName = newBaseBrowseName;
+    m_baseBrowseName = newBaseBrowseName.toUtf8();
 }
 
 QString UANode::uniqueBaseBrowseName() const
+{
+    return QString::fromUtf8(m_uniqueBaseBrowseName);
+}
+
+QByteArrayView UANode::uniqueBaseBrowseNameUtf8() const
 {
     return m_uniqueBaseBrowseName;
 }
 
 void UANode::setUniqueBaseBrowseName(const QString& newUniqueBaseBrowseName)
 {
-    m_uniqueBaseBrowseName = newUniqueBaseBrowseName;
+    m_uniqueBaseBrowseName = newUniqueBaseBrowseName.toUtf8();
 }
 
 UADataType::UADataType(const UADataType& other)
@@ -235,16 +309,21 @@ bool UADataType::operator==(const UADataType& other) const
 }
 
 QString UADataType::definitionName() const
+{
+    return AtomTable::instance()->string(m_definitionName);
+}
+
+Atom UADataType::definitionNameAtom() const
 {
     return m_definitionName;
 }
 
 void UADataType::setDefinitionName(const QString& definitionName)
 {
-    m_definitionName = definitionName;
+    m_definitionName = AtomTable::instance()->intern(definitionName);
 }
 
-QMap<QString, QString> UADataType::definitionFields() const
+const QMap<QString, QString>& UADataType::definitionFields() const
 {
     return m_definitionFields;
 }
@@ -282,6 +361,7 @@ UAVariable::UAVariable(const UAVariable& other)
     : UANode(other)
     , m_dataType(other.m_dataType)
     , m_arguments(other.m_arguments)
+    , m_value(other.m_value)
     , m_arrayDimensions(other.m_arrayDimensions)
     , m_valueRank(other.m_valueRank)
 {}
@@ -292,13 +372,14 @@ UAVariable& UAVariable::operator=(const UAVariable& other)
         UANode::operator=(other);
         m_dataType = other.m_dataType;
         m_arguments = other.m_arguments;
+        m_value = other.m_value;
         m_arrayDimensions = other.m_arrayDimensions;
         m_valueRank = other.m_valueRank;
     }
     return *this;
 }
 
-UADataType UAVariable::dataType() const
+const UADataType& UAVariable::dataType() const
 {
     return m_dataType;
 }
@@ -308,7 +389,12 @@ void UAVariable::setDataType(const UADataType& dataType)
     m_dataType = dataType;
 }
 
-QList<Argument> UAVariable::arguments() const
+void UAVariable::setDataType(UADataType&& dataType)
+{
+    m_dataType = std::move(dataType);
+}
+
+const QList<Argument>& UAVariable::arguments() const
 {
     return m_arguments;
 }
@@ -318,6 +404,26 @@ void UAVariable::setArguments(const QList<Argument>& newArguments)
     m_arguments = newArguments;
 }
 
+void UAVariable::setArguments(QList<Argument>&& newArguments)
+{
+    m_arguments = std::move(newArguments);
+}
+
+const UAValue& UAVariable::value() const
+{
+    return m_value;
+}
+
+void UAVariable::setValue(const UAValue& newValue)
+{
+    m_value = newValue;
+}
+
+void UAVariable::setValue(UAValue&& newValue)
+{
+    m_value = std::move(newValue);
+}
+
 int UAVariable::arrayDimensions() const
 {
     return m_arrayDimensions;
@@ -428,9 +534,34 @@ void UAObjectType::setIsAbstract(bool isAbstract)
     m_isAbstract = isAbstract;
 }
 
+UAReferenceType::UAReferenceType(const UAReferenceType& other)
+    : UANode(other)
+    , m_isAbstract(other.m_isAbstract)
+{}
+
+UAReferenceType& UAReferenceType::operator=(const UAReferenceType& other)
+{
+    if (this != &other) {
+        UANode::operator=(other);
+        m_isAbstract = other.m_isAbstract;
+    }
+    return *this;
+}
+
+bool UAReferenceType::isAbstract() const
+{
+    return m_isAbstract;
+}
+
+void UAReferenceType::setIsAbstract(bool isAbstract)
+{
+    m_isAbstract = isAbstract;
+}
+
 Reference::Reference(const Reference& other)
     : m_referenceType(other.m_referenceType)
     , m_targetNodeId(other.m_targetNodeId)
+    , m_targetId(other.m_targetId)
     , m_isForward(other.m_isForward)
     , m_namespaceString(other.m_namespaceString)
     , m_node(other.m_node)
@@ -441,6 +572,7 @@ Reference& Reference::operator=(const Reference& other)
     if (this != &other) {
         m_referenceType = other.m_referenceType;
         m_targetNodeId = other.m_targetNodeId;
+        m_targetId = other.m_targetId;
         m_isForward = other.m_isForward;
         m_namespaceString = other.m_namespaceString;
         m_node = other.m_node;
@@ -449,23 +581,39 @@ Reference& Reference::operator=(const Reference& other)
 }
 
 QString Reference::referenceType() const
+{
+    return AtomTable::instance()->string(m_referenceType);
+}
+
+Atom Reference::referenceTypeAtom() const
 {
     return m_referenceType;
 }
 
 void Reference::setReferenceType(const QString& referenceType)
 {
-    m_referenceType = referenceType;
+    m_referenceType = AtomTable::instance()->intern(referenceType);
 }
 
 QString Reference::targetNodeId() const
+{
+    return QString::fromUtf8(m_targetNodeId);
+}
+
+QByteArrayView Reference::targetNodeIdUtf8() const
 {
     return m_targetNodeId;
 }
 
+const UANodeId& Reference::targetId() const
+{
+    return m_targetId;
+}
+
 void Reference::setTargetNodeId(const QString& targetId)
 {
-    m_targetNodeId = targetId;
+    m_targetNodeId = targetId.toUtf8();
+    m_targetId = UANodeId::fromString(targetId);
 }
 
 bool Reference::isForward() const
@@ -479,13 +627,18 @@ void Reference::setIsForward(bool isForward)
 }
 
 QString Reference::namespaceString() const
+{
+    return AtomTable::instance()->string(m_namespaceString);
+}
+
+Atom Reference::namespaceAtom() const
 {
     return m_namespaceString;
 }
 
 void Reference::setNamespaceString(const QString& newNamespaceString)
 {
-    m_namespaceString = newNamespaceString;
+    m_namespaceString = AtomTable::instance()->intern(newNamespaceString);
 }
 
 std::shared_ptr<UANode> Reference::node() const
@@ -7,7 +7,11 @@
 #ifndef UANODE_H
 #define UANODE_H
 
+#include "Util/AtomTable.h"
 #include "Util/Utils.h"
+#include "uanodeid.h"
+#include "uavalue.h"
+#include <QByteArrayView>
 #include <QMap>
 #include <QString>
 #include <qobject.h>
@@ -33,16 +37,16 @@ public:
         const QString& parentNodeId = QStringLiteral(""),
         const QString& displayName = QStringLiteral(""),
         const QString& description = QStringLiteral(""))
-        : m_nodeId(nodeId)
-        , m_browseName(browseName)
+        : m_nodeId(nodeId.toUtf8())
+        , m_browseName(browseName.toUtf8())
         , m_references(references)
-        , m_parentNodeId(parentNodeId)
-        , m_displayName(displayName)
-        , m_description(description)
-        , m_baseBrowseName(browseName)
+        , m_parentNodeId(parentNodeId.toUtf8())
+        , m_displayName(displayName.toUtf8())
+        , m_description(description.toUtf8())
+        , m_baseBrowseName(m_browseName)
     {
         qDebug() << "we are in the node constructor" << "Nodeid" << nodeId << " browseName "
-                 << browseName << "base" << m_baseBrowseName;
+                 << browseName << "base" << baseBrowseName();
     }
 
     virtual ~UANode();
@@ -50,65 +54,101 @@ public:
     virtual std::shared_ptr<UANode> clone() const { return std::make_shared<UANode>(*this); };
     virtual QString typeName() const { return XmlTags::UANode; }
 
+    // Copies get their own references, moves take them over
     UANode(const UANode& other);
     UANode& operator=(const UANode& other);
+    UANode(UANode&& other) noexcept = default;
+    UANode& operator=(UANode&& other) noexcept = default;
 
+    // The QString getters convert for QML, the models and the code generation. The *Utf8 views
+    // are for everything else, they don't allocate and are valid until the node is changed.
     QString nodeId() const;
+    QByteArrayView nodeIdUtf8() const;
     void setNodeId(const QString& nodeId);
 
     QString browseName() const;
+    QByteArrayView browseNameUtf8() const;
     void setBrowseName(const QString& browseName);
 
     QString displayName() const;
+    QByteArrayView displayNameUtf8() const;
     void setDisplayName(const QString& displayName);
 
-    QList<std::shared_ptr<Reference>> references() const;
+    const QList<std::shared_ptr<Reference>>& references() const;
     void addReference(std::shared_ptr<Reference> reference);
+    void clearReferences();
 
     QString parentNodeId() const;
+    QByteArrayView parentNodeIdUtf8() const;
     void setParentNodeId(const QString& parentNodeId);
 
     QString description() const;
+    QByteArrayView descriptionUtf8() const;
     void setDescription(const QString& description);
 
     std::weak_ptr<UANode> parentNode() const;
     void setParentNode(std::weak_ptr<UANode> parentNode);
 
     QString namespaceString() const;
+    Atom namespaceAtom() const;
     void setNamespaceString(const QString& newNamespaceString);
+    void setNamespaceAtom(Atom namespaceAtom);
+
+    // All strings of the node in their stored UTF-8 form, as NodeSetSnapshot writes them
+    struct Utf8Strings
+    {
+        QByteArray nodeId;
+        QByteArray browseName;
+        QByteArray baseBrowseName;
+        QByteArray uniqueBaseBrowseName;
+        QByteArray displayName;
+        QByteArray nodeVariableName;
+        QByteArray description;
+        QByteArray parentNodeId;
+    };
+    // Takes the strings over as they are. Unlike setBrowseName it does not derive the variable
+    // name again, that is the caller's.
+    void setUtf8Strings(Utf8Strings&& strings);
 
     bool isOptional() const;
     void setIsOptional(bool newIsOptional);
 
     void changeNamespaceId(const int newNamespaceId);
+    // nodeId with the namespace index replaced, unchanged if it has none
+    static QString nodeIdWithNamespaceId(const QString& nodeId, const int newNamespaceId);
 
     bool isRootNode() const;
     void setIsRootNode(bool newIsRootNode);
 
     QString nodeVariableName() const;
+    QByteArrayView nodeVariableNameUtf8() const;
     void setNodeVariableName();
+    static QString nodeVariableName(const QString& browseName, const QString& nodeId);
 
     QString baseBrowseName() const;
+    QByteArrayView baseBrowseNameUtf8() const;
 
     void setBaseBrowseName(const QString& newBaseBrowseName);
 
     QString uniqueBaseBrowseName() const;
+    QByteArrayView uniqueBaseBrowseNameUtf8() const;
     void setUniqueBaseBrowseName(const QString& newUniqueBaseBrowseName);
 
 signals:
     void uniqueBaseBrowseNameChanged();
 
 private:
-    QString m_nodeId;
-    QString m_browseName;
-    QString m_baseBrowseName;
-    QString m_uniqueBaseBrowseName;
-    QString m_displayName;
-    QString m_nodeVariableName;
-    QString m_description;
+    // The strings are almost always ASCII and are stored as UTF-8, which halves their size.
+    QByteArray m_nodeId;
+    QByteArray m_browseName;
+    QByteArray m_baseBrowseName;
+    QByteArray m_uniqueBaseBrowseName;
+    QByteArray m_displayName;
+    QByteArray m_nodeVariableName;
+    QByteArray m_description;
     QList<std::shared_ptr<Reference>> m_references;
-    QString m_parentNodeId;
-    QString m_namespaceString;
+    QByteArray m_parentNodeId;
+    Atom m_namespaceString = 0;
     std::weak_ptr<UANode> m_parentNode;
     bool m_isOptional = false;
     bool m_isRootNode = false;
@@ -132,19 +172,22 @@ public:
 
     UADataType(const UADataType& other);
     UADataType& operator=(const UADataType& other);
+    UADataType(UADataType&& other) noexcept = default;
+    UADataType& operator=(UADataType&& other) noexcept = default;
     bool operator==(const UADataType& other) const;
 
     QString definitionName() const;
+    Atom definitionNameAtom() const;
     void setDefinitionName(const QString& definitionName);
 
-    QMap<QString, QString> definitionFields() const;
+    const QMap<QString, QString>& definitionFields() const;
     void addDefinitionField(const QString& fieldName, const QString& fieldType);
 
     bool isEnum() const;
     void setIsEnum(bool newIsEnum);
 
 private:
-    QString m_definitionName;
+    Atom m_definitionName = 0;
     // DefinitionName -> DataType -> Value. If there is no DataType, we have an enum.
     QMap<QString, QString> m_definitionFields;
     bool m_isEnum = false;
@@ -165,6 +208,8 @@ public:
     std::shared_ptr<UANode> clone() const override { return std::make_shared<UAObject>(*this); }
     UAObject(const UAObject& other);
     UAObject& operator=(const UAObject& other);
+    UAObject(UAObject&& other) noexcept = default;
+    UAObject& operator=(UAObject&& other) noexcept = default;
 };
 
 class UAVariable : public UANode
@@ -183,20 +228,26 @@ public:
 
     UAVariable(const UAVariable& other);
     UAVariable& operator=(const UAVariable& other);
+    UAVariable(UAVariable&& other) noexcept = default;
+    UAVariable& operator=(UAVariable&& other) noexcept = default;
 
-    UADataType dataType() const;
+    const UADataType& dataType() const;
     void setDataType(const UADataType& dataType);
+    void setDataType(UADataType&& dataType);
 
-    QVariant value() const;
-    void setValue(const QVariant& newValue);
+    // default value from the NodeSet, Null if there is none or it is not a built-in type
+    const UAValue& value() const;
+    void setValue(const UAValue& newValue);
+    void setValue(UAValue&& newValue);
 
     QStringList valueModel() const;
 
     int valueModelIndex() const;
     void setValueModelIndex(int newValueModelIndex);
 
-    QList<Argument> arguments() const;
+    const QList<Argument>& arguments() const;
     void setArguments(const QList<Argument>& newArguments);
+    void setArguments(QList<Argument>&& newArguments);
 
     int arrayDimensions() const;
     void setArrayDimensions(int newArrayDimensions);
@@ -207,6 +258,7 @@ public:
 private:
     UADataType m_dataType;
     QList<Argument> m_arguments;
+    UAValue m_value;
     int m_arrayDimensions = 1;
     int m_valueRank = -1;
 };
@@ -227,6 +279,8 @@ public:
 
     UAMethod(const UAMethod& other);
     UAMethod& operator=(const UAMethod& other);
+    UAMethod(UAMethod&& other) noexcept = default;
+    UAMethod& operator=(UAMethod&& other) noexcept = default;
 
     void setInputArgument(std::shared_ptr<UAVariable> var);
     void setOutputArgument(std::shared_ptr<UAVariable> var);
@@ -259,6 +313,8 @@ public:
 
     UAVariableType(const UAVariableType& other);
     UAVariableType& operator=(const UAVariableType& other);
+    UAVariableType(UAVariableType&& other) noexcept = default;
+    UAVariableType& operator=(UAVariableType&& other) noexcept = default;
 
     bool isAbstract() const;
     void setIsAbstract(bool isAbstract);
@@ -284,6 +340,8 @@ public:
 
     UAObjectType(const UAObjectType& other);
     UAObjectType& operator=(const UAObjectType& other);
+    UAObjectType(UAObjectType&& other) noexcept = default;
+    UAObjectType& operator=(UAObjectType&& other) noexcept = default;
 
     bool isAbstract() const;
     void setIsAbstract(bool isAbstract);
@@ -292,6 +350,36 @@ private:
     bool m_isAbstract;
 };
 
+class UAReferenceType : public UANode
+{
+public:
+    UAReferenceType(){};
+    UAReferenceType(const QString& nodeId, const QString& browseName, bool isAbstract = false)
+        : UANode(nodeId, browseName)
+        , m_isAbstract(isAbstract)
+    {}
+
+    virtual ~UAReferenceType() {}
+
+    QString typeName() const override { return XmlTags::UAReferenceType; }
+
+    std::shared_ptr<UANode> clone() const override
+    {
+        return std::make_shared<UAReferenceType>(*this);
+    }
+
+    UAReferenceType(const UAReferenceType& other);
+    UAReferenceType& operator=(const UAReferenceType& other);
+    UAReferenceType(UAReferenceType&& other) noexcept = default;
+    UAReferenceType& operator=(UAReferenceType&& other) noexcept = default;
+
+    bool isAbstract() const;
+    void setIsAbstract(bool isAbstract);
+
+private:
+    bool m_isAbstract = false;
+};
+
 class Reference
 {
 public:
@@ -303,38 +391,57 @@ public:
         bool isForward = true,
         const QString& namespaceString = QStringLiteral(""),
         std::weak_ptr<UANode> node = std::weak_ptr<UANode>{})
+        : m_referenceType(AtomTable::instance()->intern(referenceType))
+        , m_targetNodeId(targetNodeId.toUtf8())
+        , m_targetId(UANodeId::fromString(targetNodeId))
+        , m_isForward(isForward)
+        , m_namespaceString(AtomTable::instance()->intern(namespaceString))
+        , m_node(node)
+    {}
+
+    // From the stored form, see NodeSetSnapshot
+    Reference(
+        Atom referenceType, const QByteArray& targetNodeId, bool isForward, Atom namespaceString)
         : m_referenceType(referenceType)
         , m_targetNodeId(targetNodeId)
+        , m_targetId(UANodeId::fromUtf8(targetNodeId))
         , m_isForward(isForward)
         , m_namespaceString(namespaceString)
-        , m_node(node)
     {}
 
     QString typeName() const { return XmlTags::Reference; }
 
     Reference(const Reference& other);
     Reference& operator=(const Reference& other);
+    Reference(Reference&& other) noexcept = default;
+    Reference& operator=(Reference&& other) noexcept = default;
 
     QString referenceType() const;
+    Atom referenceTypeAtom() const;
     void setReferenceType(const QString& referenceType);
 
     QString targetNodeId() const;
+    QByteArrayView targetNodeIdUtf8() const;
+    // the parsed targetNodeId, looking the target up needs neither parsing nor the AtomTable
+    const UANodeId& targetId() const;
     void setTargetNodeId(const QString& targetId);
 
     bool isForward() const;
     void setIsForward(bool isForward);
 
     QString namespaceString() const;
+    Atom namespaceAtom() const;
     void setNamespaceString(const QString& newNamespaceString);
 
     std::shared_ptr<UANode> node() const;
     void setNode(std::shared_ptr<UANode> node);
 
 private:
-    QString m_referenceType;
-    QString m_targetNodeId;
+    Atom m_referenceType = 0;
+    QByteArray m_targetNodeId;
+    UANodeId m_targetId;
     bool m_isForward;
-    QString m_namespaceString;
+    Atom m_namespaceString = 0;
     std::weak_ptr<UANode> m_node;
 };
 
@@ -0,0 +1,188 @@
+// SPDX-FileCopyrightText: 2025 Marius Dege <marius.dege@basyskom.com>
+// SPDX-FileCopyrightText: 2024 Marius Dege <marius.dege@basyskom.com>
+// SPDX-FileCopyrightText: 2024 basysKom GmbH
+
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "uanodeid.h"
+#include <QStringDecoder>
+#include <QVarLengthArray>
+#include <limits>
+
+namespace {
+
+bool parseNumber(QStringView digits, quint32& number)
+{
+    if (digits.isEmpty())
+        return false;
+    quint64 value = 0;
+    for (const QChar c : digits) {
+        if (c < QLatin1Char('0') || c > QLatin1Char('9'))
+            return false;
+        value = value * 10 + (c.unicode() - u'0');
+        if (value > std::numeric_limits<quint32>::max())
+            return false;
+    }
+    number = quint32(value);
+    return true;
+}
+
+} // namespace
+
+UANodeId::UANodeId(quint16 namespaceIndex, quint32 numericIdentifier)
+    : m_identifier(numericIdentifier)
+    , m_namespaceIndex(namespaceIndex)
+    , m_identifierType(IdentifierType::Numeric)
+{}
+
+UANodeId UANodeId::fromString(QStringView nodeId)
+{
+    return parse(nodeId, true);
+}
+
+UANodeId UANodeId::lookup(QStringView nodeId)
+{
+    return parse(nodeId, false);
+}
+
+UANodeId UANodeId::fromUtf8(QByteArrayView nodeId)
+{
+    return parseUtf8(nodeId, true);
+}
+
+UANodeId UANodeId::lookupUtf8(QByteArrayView nodeId)
+{
+    return parseUtf8(nodeId, false);
+}
+
+UANodeId UANodeId::parseUtf8(QByteArrayView nodeId, bool intern)
+{
+    // NodeIds are short, decoding them on the stack keeps the parsing free of allocations
+    QStringDecoder decoder(QStringDecoder::Utf8);
+    QVarLengthArray<QChar, 64> buffer(decoder.requiredSpace(nodeId.size()));
+    const QChar* end = decoder.appendToBuffer(buffer.data(), nodeId);
+    return parse(QStringView(buffer.data(), end), intern);
+}
+
+UANodeId UANodeId::parse(QStringView nodeId, bool intern)
+{
+    AtomTable* atoms = AtomTable::instance();
+    const auto atom = [atoms, intern](const QString& identifier) {
+        return intern ? atoms->intern(identifier) : atoms->find(identifier);
+    };
+    UANodeId result;
+    nodeId = nodeId.trimmed();
+
+    quint32 namespaceIndex = 0;
+    if (nodeId.startsWith(u"ns=")) {
+        const qsizetype separator = nodeId.indexOf(u';');
+        if (separator < 0 || !parseNumber(nodeId.sliced(3, separator - 3), namespaceIndex)
+            || namespaceIndex > std::numeric_limits<quint16>::max()) {
+            return result;
+        }
+        nodeId = nodeId.sliced(separator + 1);
+    } else if (nodeId.startsWith(u"nsu=")) {
+        // the namespace URI is not resolved to an index, lookups only use the identifier
+        const qsizetype separator = nodeId.indexOf(u';');
+        if (separator < 0)
+            return result;
+        nodeId = nodeId.sliced(separator + 1);
+    }
+
+    if (nodeId.size() < 2 || nodeId.at(1) != QLatin1Char('='))
+        return result;
+
+    const QStringView identifier = nodeId.sliced(2);
+    switch (nodeId.at(0).unicode()) {
+    case u'i':
+        if (!parseNumber(identifier, result.m_identifier))
+            return result;
+        result.m_identifierType = IdentifierType::Numeric;
+        break;
+    case u's':
+        result.m_identifier = atom(identifier.toString());
+        result.m_identifierType = IdentifierType::String;
+        break;
+    case u'g':
+        // GUIDs are case insensitive
+        result.m_identifier = atom(identifier.toString().toLower());
+        result.m_identifierType = IdentifierType::Guid;
+        break;
+    case u'b':
+        result.m_identifier = atom(identifier.toString());
+        result.m_identifierType = IdentifierType::Opaque;
+        break;
+    default:
+        return result;
+    }
+
+    result.m_namespaceIndex = quint16(namespaceIndex);
+    return result;
+}
+
+quint32 UANodeId::numericIdentifier() const
+{
+    return m_identifierType == IdentifierType::Numeric ? m_identifier : 0;
+}
+
+QString UANodeId::stringIdentifier() const
+{
+    switch (m_identifierType) {
+    case IdentifierType::Numeric:
+        return QString::number(m_identifier);
+    case IdentifierType::String:
+    case IdentifierType::Guid:
+    case IdentifierType::Opaque:
+        return AtomTable::instance()->string(m_identifier);
+    case IdentifierType::Invalid:
+        break;
+    }
+    return QString();
+}
+
+UANodeId UANodeId::withoutNamespace() const
+{
+    UANodeId result = *this;
+    result.m_namespaceIndex = 0;
+    return result;
+}
+
+QString UANodeId::toString() const
+{
+    QString prefix;
+    switch (m_identifierType) {
+    case IdentifierType::Numeric:
+        prefix = QStringLiteral("i=");
+        break;
+    case IdentifierType::String:
+        prefix = QStringLiteral("s=");
+        break;
+    case IdentifierType::Guid:
+        prefix = QStringLiteral("g=");
+        break;
+    case IdentifierType::Opaque:
+        prefix = QStringLiteral("b=");
+        break;
+    case IdentifierType::Invalid:
+        return QString();
+    }
+
+    if (m_namespaceIndex != 0)
+        prefix = QStringLiteral("ns=%1;").arg(m_namespaceIndex) + prefix;
+    return prefix + stringIdentifier();
+}
+
+bool UANodeId::operator<(const UANodeId& other) const
+{
+    if (m_namespaceIndex != other.m_namespaceIndex)
+        return m_namespaceIndex < other.m_namespaceIndex;
+    if (m_identifierType != other.m_identifierType)
+        return m_identifierType < other.m_identifierType;
+    if (m_identifierType == IdentifierType::Numeric)
+        return m_identifier < other.m_identifier;
+    // Atoms depend on which parse thread saw a string first, the strings give a stable order
+    if (m_identifier == other.m_identifier)
+        return false;
+    const AtomTable* atoms = AtomTable::instance();
+    return atoms->string(m_identifier) < atoms->string(other.m_identifier);
+}
@@ -0,0 +1,75 @@
+// SPDX-FileCopyrightText: 2025 Marius Dege <marius.dege@basyskom.com>
+// SPDX-FileCopyrightText: 2024 Marius Dege <marius.dege@basyskom.com>
+// SPDX-FileCopyrightText: 2024 basysKom GmbH
+
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#ifndef UANODEID_H
+#define UANODEID_H
+
+#include "Util/AtomTable.h"
+#include <QByteArrayView>
+#include <QHashFunctions>
+#include <QString>
+#include <QStringView>
+
+// Parsed form of a NodeId string like "ns=1;i=5001". String, GUID and opaque identifiers are
+// interned, so every NodeId is 12 bytes and compares without touching strings.
+class UANodeId
+{
+public:
+    enum class IdentifierType : quint8 { Invalid, Numeric, String, Guid, Opaque };
+
+    UANodeId() = default;
+    UANodeId(quint16 namespaceIndex, quint32 numericIdentifier);
+
+    // Accepts "i=", "s=", "g=" and "b=" identifiers with an optional "ns=" or "nsu=" prefix.
+    // Returns an invalid NodeId for anything else. For the NodeIds of stored nodes, interns
+    // string identifiers.
+    static UANodeId fromString(QStringView nodeId);
+    // Same for looking a node up. A string identifier that was never interned can't belong to a
+    // node, it gets AtomTable::NoAtom and matches nothing.
+    static UANodeId lookup(QStringView nodeId);
+    // The same for the UTF-8 NodeIds the nodes store, numeric ones are parsed without allocating
+    static UANodeId fromUtf8(QByteArrayView nodeId);
+    static UANodeId lookupUtf8(QByteArrayView nodeId);
+
+    bool isValid() const { return m_identifierType != IdentifierType::Invalid; }
+    quint16 namespaceIndex() const { return m_namespaceIndex; }
+    IdentifierType identifierType() const { return m_identifierType; }
+    quint32 numericIdentifier() const;
+    QString stringIdentifier() const;
+
+    // The NodeId with namespace index 0. Nodes are looked up by identifier only inside a nodeset.
+    UANodeId withoutNamespace() const;
+
+    QString toString() const;
+
+    bool operator==(const UANodeId& other) const
+    {
+        return m_identifier == other.m_identifier && m_namespaceIndex == other.m_namespaceIndex
+               && m_identifierType == other.m_identifierType;
+    }
+    bool operator!=(const UANodeId& other) const { return !(*this == other); }
+    // numeric identifiers first, ordered by value
+    bool operator<(const UANodeId& other) const;
+
+    friend size_t qHash(const UANodeId& nodeId, size_t seed = 0)
+    {
+        return qHashMulti(
+            seed,
+            nodeId.m_identifier,
+            nodeId.m_namespaceIndex,
+            static_cast<quint8>(nodeId.m_identifierType));
+    }
+
+private:
+    static UANodeId parse(QStringView nodeId, bool intern);
+    static UANodeId parseUtf8(QByteArrayView nodeId, bool intern);
+
+    quint32 m_identifier = 0; // the number or the atom of the string
+    quint16 m_namespaceIndex = 0;
+    IdentifierType m_identifierType = IdentifierType::Invalid;
+};
+
+#endif // UANODEID_H
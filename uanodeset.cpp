@@ -6,6 +6,7 @@
 
 #include "uanodeset.h"
 #include "Util/Utils.h"
+#include <algorithm>
 
 UANodeSet::UANodeSet() {}
 
@@ -16,12 +17,118 @@ UANodeSet::~UANodeSet()
 
 void UANodeSet::addNode(std::shared_ptr<UANode> node)
 {
-    m_nodes.insert(Utils::instance()->extractIdentifier(node->nodeId()).toInt(), node);
+    m_nodes.insert(UANodeId::fromUtf8(node->nodeIdUtf8()).withoutNamespace(), node);
+    m_nodesSorted = false;
 }
 
 QList<std::shared_ptr<UANode>> UANodeSet::nodes() const
 {
-    return m_nodes.values();
+    if (!m_lazyNodes.isEmpty()) {
+        const QList<UANodeId> keys = m_lazyNodes.keys();
+        for (const UANodeId& key : keys) {
+            loadNode(key);
+        }
+    }
+    return sortedNodes();
+}
+
+void UANodeSet::sortNodes() const
+{
+    // ordered by NodeId, numeric ids first, like the QMap keyed by the numeric id before
+    QList<std::pair<UANodeId, std::shared_ptr<UANode>>> entries;
+    entries.reserve(m_nodes.size());
+    m_nodes.forEach([&entries](const UANodeId& key, const std::shared_ptr<UANode>& node) {
+        entries.append({key, node});
+    });
+    std::sort(entries.begin(), entries.end(), [](const auto& left, const auto& right) {
+        return left.first < right.first;
+    });
+
+    m_sortedKeys.clear();
+    m_sortedNodes.clear();
+    m_sortedKeys.reserve(entries.size());
+    m_sortedNodes.reserve(entries.size());
+    for (const auto& entry : std::as_const(entries)) {
+        m_sortedKeys.append(entry.first);
+        m_sortedNodes.append(entry.second);
+    }
+    m_nodesSorted = true;
+}
+
+const QList<std::shared_ptr<UANode>>& UANodeSet::sortedNodes() const
+{
+    // The builders sort once they are done, this only sorts a nodeset that is still being built
+    if (!m_nodesSorted)
+        sortNodes();
+    return m_sortedNodes;
+}
+
+void UANodeSet::addLazyNode(const UANodeId& nodeId, const LazyNode& lazyNode)
+{
+    m_lazyNodes.insert(nodeId.withoutNamespace(), lazyNode);
+}
+
+void UANodeSet::setNodeLoader(const NodeLoader& loader)
+{
+    m_nodeLoader = loader;
+}
+
+bool UANodeSet::isLazy() const
+{
+    return m_nodeLoader != nullptr;
+}
+
+QList<std::shared_ptr<UANode>> UANodeSet::loadedNodes() const
+{
+    return sortedNodes();
+}
+
+QList<std::shared_ptr<UANode>> UANodeSet::referenceTypes() const
+{
+    QList<UANodeId> lazyReferenceTypes;
+    for (auto it = m_lazyNodes.constBegin(); it != m_lazyNodes.constEnd(); ++it) {
+        if (it->nodeClass == XmlTags::Token::UAReferenceType)
+            lazyReferenceTypes.append(it.key());
+    }
+    for (const UANodeId& key : std::as_const(lazyReferenceTypes)) {
+        loadNode(key);
+    }
+
+    QList<std::shared_ptr<UANode>> referenceTypes;
+    m_nodes.forEach([&referenceTypes](const UANodeId&, const std::shared_ptr<UANode>& node) {
+        if (node->typeName() == XmlTags::UAReferenceType)
+            referenceTypes.append(node);
+    });
+    return referenceTypes;
+}
+
+qsizetype UANodeSet::loadedNodeCount() const
+{
+    return m_nodes.size();
+}
+
+std::shared_ptr<UANode> UANodeSet::loadNode(const UANodeId& key) const
+{
+    auto it = m_lazyNodes.constFind(key);
+    if (it == m_lazyNodes.constEnd() || !m_nodeLoader)
+        return nullptr;
+
+    // remove the entry first, a node that fails to load is not tried again
+    const LazyNode lazyNode = it.value();
+    m_lazyNodes.erase(it);
+
+    // loading is part of the lookup, see the mutable members
+    std::shared_ptr<UANode> node = m_nodeLoader(const_cast<UANodeSet&>(*this), lazyNode);
+    if (node) {
+        m_nodes.insert(key, node);
+        if (m_nodesSorted) {
+            const auto position = std::lower_bound(m_sortedKeys.cbegin(), m_sortedKeys.cend(), key)
+                                  - m_sortedKeys.cbegin();
+            m_sortedKeys.insert(position, key);
+            m_sortedNodes.insert(position, node);
+        }
+    }
+    return node;
 }
 
 QString UANodeSet::getNameSpaceUri() const
@@ -44,14 +151,21 @@ QString UANodeSet::getNamespaceUriByIndex(int index) const
 }
 
 std::shared_ptr<UANode> UANodeSet::findNodeById(const QString& nodeId) const
+{
+    return findNodeById(UANodeId::lookup(nodeId));
+}
+
+std::shared_ptr<UANode> UANodeSet::findNodeById(const UANodeId& nodeId) const
 {
     // only check for the identifier not the namespace since the nodeId might be from another Nodeset
     // this will only return the node if it is in this nodeset
-    int identifier = Utils::instance()->extractIdentifier(nodeId).toInt();
-    if (m_nodes.contains(identifier)) {
-        return m_nodes.value(identifier);
+    const UANodeId key = nodeId.withoutNamespace();
+    if (!key.isValid())
+        return nullptr;
+    if (const std::shared_ptr<UANode>* node = m_nodes.find(key)) {
+        return *node;
     }
-    return nullptr;
+    return loadNode(key);
 }
 
 QMap<int, QString> UANodeSet::namespaceMap() const
@@ -66,14 +180,28 @@ QString UANodeSet::getNodeSetName()
 
 void UANodeSet::addAlias(const QString& alias, const QString& uri)
 {
-    m_aliasMap.insert(alias, uri);
+    m_aliasMap.insert(AtomTable::instance()->intern(alias), uri);
 }
 
 QString UANodeSet::getNodeIdByAlias(const QString& alias) const
+{
+    return getNodeIdByAlias(AtomTable::instance()->find(alias));
+}
+
+QString UANodeSet::getNodeIdByAlias(Atom alias) const
 {
     return m_aliasMap.value(alias, QStringLiteral(""));
 }
 
+QMap<QString, QString> UANodeSet::aliasMap() const
+{
+    QMap<QString, QString> aliases;
+    for (auto it = m_aliasMap.constBegin(); it != m_aliasMap.constEnd(); ++it) {
+        aliases.insert(AtomTable::instance()->string(it.key()), it.value());
+    }
+    return aliases;
+}
+
 bool UANodeSet::getHasCustomTypes() const
 {
     return m_hasCustomTypes;
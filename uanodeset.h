@@ -7,20 +7,61 @@
 #ifndef UANODESET_H
 #define UANODESET_H
 
+#include "Util/Arena.h"
+#include "Util/OpenHashMap.h"
 #include "treeitem.h"
 #include "uanode.h"
+#include "uanodeid.h"
 #include <QHash>
 #include <QRegularExpression>
+#include <functional>
 
 class UANodeSet
 {
 public:
+    // Position of a node element in the NodeSet2.xml file that has not been parsed yet.
+    struct LazyNode
+    {
+        qint64 offset = 0;
+        qint64 length = 0;
+        XmlTags::Token nodeClass = XmlTags::Token::Unknown;
+    };
+    // Parses a lazy node into the given nodeset, the one that is looking it up.
+    using NodeLoader
+        = std::function<std::shared_ptr<UANode>(UANodeSet& nodeSet, const LazyNode& lazyNode)>;
+
     UANodeSet();
     ~UANodeSet();
+    UANodeSet(UANodeSet&&) = default;
+    UANodeSet& operator=(UANodeSet&&) = default;
+
+    // Creates a node or reference in the arena of this nodeset. The arena is released when the
+    // last object created from it is gone.
+    template<typename T, typename... Args>
+    std::shared_ptr<T> create(Args&&... args)
+    {
+        return std::allocate_shared<T>(ArenaAllocator<T>(m_arena), std::forward<Args>(args)...);
+    }
 
     void addNode(std::shared_ptr<UANode> node);
+    // Orders the nodes by NodeId, called once all nodes are added. nodes() and loadedNodes() return
+    // this order without sorting again, lazy nodes are inserted into it when they are loaded.
+    void sortNodes() const;
+    // loads all lazy nodes first
     QList<std::shared_ptr<UANode>> nodes() const;
 
+    // Lazy nodes are parsed with the loader on first access through findNodeById or nodes().
+    // These const lookups then modify the nodeset without a lock, so a lazy nodeset must only be
+    // used by one thread at a time. The parallel link phase of the resolver skips lazy nodesets.
+    void addLazyNode(const UANodeId& nodeId, const LazyNode& lazyNode);
+    void setNodeLoader(const NodeLoader& loader);
+    bool isLazy() const;
+    QList<std::shared_ptr<UANode>> loadedNodes() const;
+    // The UAReferenceType nodes, lazy ones are loaded. They are needed to interpret the
+    // references of all other nodes.
+    QList<std::shared_ptr<UANode>> referenceTypes() const;
+    qsizetype loadedNodeCount() const;
+
     QString getNameSpaceUri() const;
     void setNamespaceUri(const QString& newUri);
 
@@ -28,6 +69,7 @@ public:
     QString getNamespaceUriByIndex(int index) const;
 
     std::shared_ptr<UANode> findNodeById(const QString& nodeId) const;
+    std::shared_ptr<UANode> findNodeById(const UANodeId& nodeId) const;
 
     QMap<int, QString> namespaceMap() const;
 
@@ -35,23 +77,36 @@ public:
 
     void addAlias(const QString& alias, const QString& uri);
     QString getNodeIdByAlias(const QString& alias) const;
+    QString getNodeIdByAlias(Atom alias) const;
+    QMap<QString, QString> aliasMap() const;
 
     bool getHasCustomTypes() const;
     void setHasCustomTypes(bool newHasCustomTypes);
 
 private:
-    // QMap with the identifier as key without the namespace
-    QMap<int, std::shared_ptr<UANode>> m_nodes;
+    // Keyed by the NodeId without the namespace, see findNodeById.
+    // Mutable, because lookups load lazy nodes on demand.
+    mutable OpenHashMap<UANodeId, std::shared_ptr<UANode>> m_nodes;
+    mutable QHash<UANodeId, LazyNode> m_lazyNodes;
+    // the nodes of m_nodes ordered by NodeId, see sortNodes
+    mutable QList<UANodeId> m_sortedKeys;
+    mutable QList<std::shared_ptr<UANode>> m_sortedNodes;
+    mutable bool m_nodesSorted = true;
+    NodeLoader m_nodeLoader;
+    std::shared_ptr<Arena> m_arena = std::make_shared<Arena>();
 
     // mappping of namespace index to namespace uri for the nodeset
     QMap<int, QString> m_namespaceMap;
-    QMap<QString, QString> m_aliasMap;
+    // alias name -> NodeId
+    QHash<Atom, QString> m_aliasMap;
 
     bool m_hasCustomTypes = false;
 
     QString m_uri;
 
     void resolveNamespaceMapping(TreeItem* item);
+    std::shared_ptr<UANode> loadNode(const UANodeId& key) const;
+    const QList<std::shared_ptr<UANode>>& sortedNodes() const;
 };
 
 #endif // UANODESET_H
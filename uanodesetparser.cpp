@@ -5,105 +5,550 @@
 // SPDX-License-Identifier: LGPL-3.0-or-later
 
 #include "uanodesetparser.h"
+#include "Util/DecompressingDevice.h"
 #include "Util/Utils.h"
+#include <QDateTime>
+#include <QFileInfo>
+#include <QMutex>
+#include <type_traits>
+
+using Token = XmlTags::Token;
+
+namespace {
+
+bool isNodeElement(Token token)
+{
+    switch (token) {
+    case Token::UAObject:
+    case Token::UADataType:
+    case Token::UAVariable:
+    case Token::UAMethod:
+    case Token::UAVariableType:
+    case Token::UAObjectType:
+    case Token::UAReferenceType:
+        return true;
+    default:
+        return false;
+    }
+}
+
+QString elementName(QStringView name)
+{
+    return name.toString();
+}
+
+QString elementName(QByteArrayView name)
+{
+    return QString::fromUtf8(name);
+}
+
+bool isNameEnd(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '>' || c == '/';
+}
+
+// Position after the '>' closing the tag, skipping quoted attribute values. -1 if there is none.
+qsizetype findTagEnd(QByteArrayView data, qsizetype from)
+{
+    char quote = 0;
+    for (qsizetype i = from; i < data.size(); ++i) {
+        const char c = data[i];
+        if (quote) {
+            if (c == quote)
+                quote = 0;
+        } else if (c == '"' || c == '\'') {
+            quote = c;
+        } else if (c == '>') {
+            return i + 1;
+        }
+    }
+    return -1;
+}
+
+// Raw value of an attribute in a start tag. Entities are not decoded, see
+// NodeSetTokenizer::decodeAttributeValue.
+QByteArrayView attributeValue(QByteArrayView tag, QByteArrayView name)
+{
+    qsizetype pos = 0;
+    while ((pos = tag.indexOf(name, pos)) > 0) {
+        const qsizetype equals = pos + name.size();
+        // the name has to follow whitespace, otherwise "NodeId" would also match "ParentNodeId"
+        if (isNameEnd(tag[pos - 1]) && equals + 1 < tag.size() && tag[equals] == '=') {
+            const char quote = tag[equals + 1];
+            const qsizetype valueEnd = tag.indexOf(quote, equals + 2);
+            if ((quote == '"' || quote == '\'') && valueEnd >= 0)
+                return tag.sliced(equals + 2, valueEnd - equals - 2);
+        }
+        pos = equals;
+    }
+    return {};
+}
+
+} // namespace
 
 UaNodeSetParser::UaNodeSetParser() {}
 
+UaNodeSetParser::ModelHeader UaNodeSetParser::readModelHeader(const QString& filePath)
+{
+    struct CachedHeader
+    {
+        QDateTime lastModified;
+        qint64 size = -1;
+        ModelHeader header;
+    };
+    static QMutex cacheMutex;
+    static QHash<QString, CachedHeader> cache;
+
+    const QFileInfo fileInfo(filePath);
+    const QDateTime lastModified = fileInfo.lastModified();
+    const qint64 size = fileInfo.size();
+    {
+        QMutexLocker locker(&cacheMutex);
+        const auto it = cache.constFind(filePath);
+        if (it != cache.constEnd() && it->lastModified == lastModified && it->size == size)
+            return it->header;
+    }
+
+    ModelHeader header;
+    // only the start of the file is decompressed
+    DecompressingDevice file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "Cannot open file for reading:" << file.errorString() << filePath;
+        return header;
+    }
+
+    QXmlStreamReader xml(&file);
+    while (!xml.atEnd()) {
+        xml.readNext();
+        if (xml.isStartElement()) {
+            const Token token = XmlTags::token(xml.name());
+            if (token == Token::RequiredModel || token == Token::Model) {
+                const QXmlStreamAttributes attributes = xml.attributes();
+                const QStringView modelUri = attributes.value(XmlTags::ModelUri);
+                if (!modelUri.isEmpty()) {
+                    header.modelUris.append(modelUri.toString());
+                    // NOTE the Model is the URI of the selected Companion Specification.
+                    if (token == Token::Model) {
+                        header.modelUri = header.modelUris.last();
+                        header.version = attributes.value(XmlTags::Version).toString();
+                        header.publicationDate
+                            = attributes.value(XmlTags::PublicationDate).toString();
+                    }
+                }
+            } else if (isNodeElement(token)) {
+                // no Models block in this file
+                break;
+            }
+        } else if (xml.isEndElement() && XmlTags::token(xml.name()) == Token::Models) {
+            break;
+        }
+    }
+
+    if (xml.hasError()) {
+        qWarning() << "XML error:" << xml.errorString() << filePath;
+        return header;
+    }
+
+    QMutexLocker locker(&cacheMutex);
+    cache.insert(filePath, {lastModified, size, header});
+    return header;
+}
+
 bool UaNodeSetParser::parse(const QString& filePath, UANodeSet* nodeSet)
 {
-    m_file.setFileName(filePath);
-    if (!m_file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        qWarning() << "Cannot open file for reading:" << m_file.errorString() << filePath;
+    if (DecompressingDevice::compression(filePath) != DecompressingDevice::Compression::None) {
+        // decompressed in chunks while the reader pulls the data
+        DecompressingDevice device(filePath);
+        if (!device.open(QIODevice::ReadOnly)) {
+            qWarning() << "Cannot open file for reading:" << device.errorString() << filePath;
+            return false;
+        }
+        QXmlStreamReader xml(&device);
+        return parseDocument(xml, nodeSet);
+    }
+
+    // The file is local to the call, so a parser instance can be used on any thread.
+    // No Text mode: the reader handles line endings itself and must see the raw UTF-8 bytes.
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "Cannot open file for reading:" << file.errorString() << filePath;
         return false;
     }
 
-    QXmlStreamReader xml(&m_file);
+    // Parse straight from the mapped file, so the content is not copied through the QIODevice
+    // buffers. Fall back to reading from the device if the file cannot be mapped.
+    uchar* mapped = nullptr;
+    if (m_useMemoryMap && file.size() > 0)
+        mapped = file.map(0, file.size());
+
+    bool success = false;
+    if (mapped) {
+        const QByteArrayView data(reinterpret_cast<const char*>(mapped), file.size());
+        if (m_useFastTokenizer) {
+            NodeSetTokenizer tokenizer(data);
+            success = parseDocument(tokenizer, nodeSet);
+            if (!success) {
+                // Start over with an empty nodeset, QXmlStreamReader reports real errors.
+                qDebug() << "Fast tokenizer stopped at byte" << tokenizer.position() << "of"
+                         << filePath << "(" << tokenizer.errorString()
+                         << "), parsing it with QXmlStreamReader";
+                *nodeSet = UANodeSet();
+                // so the reparse logs the skipped value types again
+                m_skippedValueTypes.clear();
+            }
+        }
+        if (!success) {
+            // Scoped, so the reader is gone before the mapping is released.
+            QXmlStreamReader xml(QByteArray::fromRawData(data.data(), data.size()));
+            success = parseDocument(xml, nodeSet);
+        }
+        file.unmap(mapped);
+    } else {
+        QXmlStreamReader xml(&file);
+        success = parseDocument(xml, nodeSet);
+    }
+
+    file.close();
+    return success;
+}
+
+template<typename Reader>
+bool UaNodeSetParser::parseDocument(Reader& xml, UANodeSet* nodeSet)
+{
     while (!xml.atEnd()) {
         xml.readNext();
         if (xml.isStartElement()) {
-            if (xml.name().toString() == XmlTags::UANodeSet) {
+            if (XmlTags::token(xml.name()) == Token::UANodeSet) {
                 parseNodeSet(xml, nodeSet);
             }
         }
     }
 
-    m_file.close();
-
     if (xml.hasError()) {
-        qWarning() << "XML error:" << xml.errorString();
+        // the tokenizer errors are only a reason to fall back, see parse
+        if constexpr (std::is_same_v<Reader, QXmlStreamReader>)
+            qWarning() << "XML error:" << xml.errorString();
         return false;
     }
 
+    nodeSet->sortNodes();
     return true;
 }
 
-void UaNodeSetParser::parseNodeSet(QXmlStreamReader& xml, UANodeSet* nodeSet)
+void UaNodeSetParser::setUseMemoryMap(bool useMemoryMap)
+{
+    m_useMemoryMap = useMemoryMap;
+}
+
+void UaNodeSetParser::setUseFastTokenizer(bool useFastTokenizer)
+{
+    m_useFastTokenizer = useFastTokenizer;
+}
+
+bool UaNodeSetParser::index(const QString& filePath, UANodeSet* nodeSet)
+{
+    // The nodes are loaded by seeking to their offset, a compressed file has to be read in full.
+    if (DecompressingDevice::compression(filePath) != DecompressingDevice::Compression::None)
+        return parse(filePath, nodeSet);
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "Cannot open file for reading:" << file.errorString() << filePath;
+        return false;
+    }
+
+    uchar* mapped = file.size() > 0 ? file.map(0, file.size()) : nullptr;
+    if (!mapped) {
+        qWarning() << "Cannot map file, parsing all nodes:" << filePath;
+        file.close();
+        return parse(filePath, nodeSet);
+    }
+    const QByteArrayView data(reinterpret_cast<const char*>(mapped), file.size());
+    // the offsets are only valid as long as the file stays the same
+    const QDateTime lastModified = QFileInfo(filePath).lastModified();
+    const qint64 size = file.size();
+
+    bool success = true;
+    {
+        // The namespaces and aliases are needed to parse any node, so the header is read eagerly.
+        QXmlStreamReader xml(QByteArray::fromRawData(data.data(), data.size()));
+        while (!xml.atEnd()) {
+            xml.readNext();
+            if (!xml.isStartElement())
+                continue;
+            const Token token = XmlTags::token(xml.name());
+            if (token == Token::Models) {
+                parseNamespaceMappping(xml, nodeSet);
+            } else if (token == Token::Aliases) {
+                parseAliases(xml, nodeSet);
+            } else if (isNodeElement(token)) {
+                break;
+            }
+        }
+        if (xml.hasError()) {
+            qWarning() << "XML error:" << xml.errorString();
+            success = false;
+        }
+    }
+
+    // Scan the bytes for the node elements and only record where they are.
+    QByteArray rootStartTag;
+    QByteArray rootEndTag;
+    qsizetype pos = 0;
+    while (success && (pos = data.indexOf('<', pos)) >= 0) {
+        const QByteArrayView rest = data.sliced(pos);
+        if (rest.startsWith("<!--") || rest.startsWith("<![CDATA[")) {
+            const QByteArrayView terminator = rest.startsWith("<!--") ? "-->" : "]]>";
+            const qsizetype end = data.indexOf(terminator, pos);
+            if (end < 0)
+                break;
+            pos = end + terminator.size();
+            continue;
+        }
+        if (rest.startsWith("</") || rest.startsWith("<?") || rest.startsWith("<!")) {
+            pos += 2;
+            continue;
+        }
+
+        qsizetype nameEnd = pos + 1;
+        while (nameEnd < data.size() && !isNameEnd(data[nameEnd]))
+            ++nameEnd;
+        const QByteArrayView name = data.sliced(pos + 1, nameEnd - pos - 1);
+        const qsizetype tagEnd = findTagEnd(data, nameEnd);
+        if (tagEnd < 0)
+            break;
+
+        // the elements may carry a namespace prefix, like ua:UAObject
+        const Token token = XmlTags::token(name.sliced(name.indexOf(':') + 1));
+        if (token == Token::UANodeSet) {
+            // the root start tag declares the namespace prefixes used inside the nodes
+            rootStartTag = data.sliced(pos, tagEnd - pos).toByteArray();
+            rootEndTag = "</" + name.toByteArray() + '>';
+        } else if (isNodeElement(token)) {
+            qsizetype elementEnd = tagEnd;
+            if (data[tagEnd - 2] != '/') {
+                // node elements never contain an element with their own name
+                const QByteArray endTag = "</" + name.toByteArray() + '>';
+                const qsizetype endTagPos = data.indexOf(endTag, tagEnd);
+                if (endTagPos < 0) {
+                    qWarning() << "Unterminated" << name << "element in" << filePath;
+                    success = false;
+                    break;
+                }
+                elementEnd = endTagPos + endTag.size();
+            }
+
+            // decoded, so string NodeIds with entities get the key the reference targets look up
+            QString nodeId;
+            if (!NodeSetTokenizer::decodeAttributeValue(
+                    attributeValue(data.sliced(pos, tagEnd - pos), "NodeId"), nodeId)) {
+                qWarning() << "Invalid entity reference in the NodeId of a" << name << "in"
+                           << filePath;
+                success = false;
+                break;
+            }
+            nodeSet->addLazyNode(UANodeId::fromString(nodeId), {pos, elementEnd - pos, token});
+            if (token == Token::UADataType)
+                nodeSet->setHasCustomTypes(true);
+
+            pos = elementEnd;
+            continue;
+        }
+        pos = tagEnd;
+    }
+
+    file.unmap(mapped);
+    file.close();
+
+    if (!success)
+        return false;
+    if (rootStartTag.isEmpty()) {
+        qWarning() << "No UANodeSet element found in" << filePath;
+        return false;
+    }
+
+    // Nodes are read back from the file on demand, so the file is neither kept open nor mapped.
+    nodeSet->setNodeLoader(
+        [filePath, rootStartTag, rootEndTag, lastModified, size](
+            UANodeSet& nodeSet, const UANodeSet::LazyNode& lazyNode) -> std::shared_ptr<UANode> {
+            QFile file(filePath);
+            if (QFileInfo(filePath).lastModified() != lastModified || file.size() != size) {
+                qWarning() << "Cannot load node at offset" << lazyNode.offset << "from" << filePath
+                           << "- the file changed since it was indexed";
+                return nullptr;
+            }
+            if (file.open(QIODevice::ReadOnly) && file.seek(lazyNode.offset)) {
+                QXmlStreamReader xml;
+                xml.addData(rootStartTag);
+                xml.addData(file.read(lazyNode.length));
+                xml.addData(rootEndTag);
+                while (!xml.atEnd()) {
+                    xml.readNext();
+                    if (!xml.isStartElement())
+                        continue;
+                    const Token token = XmlTags::token(xml.name());
+                    // a different element means the file changed since it was indexed
+                    if (token == lazyNode.nodeClass) {
+                        UaNodeSetParser parser;
+                        return parser.parseNode(xml, token, &nodeSet);
+                    } else if (token != Token::UANodeSet) {
+                        break;
+                    }
+                }
+            }
+            qWarning() << "Cannot load node at offset" << lazyNode.offset << "from" << filePath;
+            return nullptr;
+        });
+
+    return true;
+}
+
+template<typename Reader>
+UaNodeSetParser::NodeAttributes UaNodeSetParser::readNodeAttributes(Reader& xml)
+{
+    NodeAttributes attributes;
+    const auto& xmlAttributes = xml.attributes();
+    for (const auto& attribute : xmlAttributes) {
+        switch (XmlTags::token(attribute.name())) {
+        case Token::NodeId:
+            attributes.nodeId = attribute.value().toString();
+            break;
+        case Token::BrowseName:
+            attributes.browseName = attribute.value().toString();
+            break;
+        case Token::Description:
+            attributes.description = attribute.value().toString();
+            break;
+        case Token::ParentNodeId:
+            attributes.parentNodeId = attribute.value().toString();
+            break;
+        case Token::DataType:
+            attributes.dataType = attribute.value().toString();
+            break;
+        case Token::ValueRank:
+            attributes.valueRank = attribute.value().toInt();
+            break;
+        case Token::ArrayDimensions:
+            attributes.arrayDimensions = attribute.value().toInt();
+            break;
+        case Token::IsAbstract:
+            attributes.isAbstract = attribute.value() == QLatin1StringView("true");
+            break;
+        default:
+            break;
+        }
+    }
+    return attributes;
+}
+
+void UaNodeSetParser::applyNodeAttributes(
+    const NodeAttributes& attributes, std::shared_ptr<UANode> node, UANodeSet* nodeSet)
+{
+    // the nodeId has to be set first, the variable name is derived from it in setBrowseName
+    node->setNodeId(attributes.nodeId);
+    node->setBrowseName(attributes.browseName);
+    node->setBaseBrowseName(attributes.browseName);
+    node->setDescription(attributes.description);
+    node->setParentNodeId(attributes.parentNodeId);
+    node->setNamespaceString(nodeSet->getNameSpaceUri());
+}
+
+template<typename Reader>
+void UaNodeSetParser::parseNodeSet(Reader& xml, UANodeSet* nodeSet)
 {
     while (!xml.atEnd()) {
         xml.readNext();
         if (xml.isStartElement()) {
             // TODO Verify that the Models Emelement is present in all cases. if not use NamespaceUri from the UANodeSet Element
-            if (xml.name().toString() == XmlTags::Models) {
+            const Token token = XmlTags::token(xml.name());
+            switch (token) {
+            case Token::Models:
                 parseNamespaceMappping(xml, nodeSet);
-            } else if (xml.name().toString() == XmlTags::UAObject) {
-                std::shared_ptr<UAObject> object = std::make_shared<UAObject>();
-                parseUAObject(xml, object, nodeSet);
-                nodeSet->addNode(object);
-            } else if (xml.name().toString() == XmlTags::UADataType) {
-                nodeSet->setHasCustomTypes(true);
-                std::shared_ptr<UADataType> dataType = std::make_shared<UADataType>();
-                parseUADataType(xml, dataType, nodeSet);
-                nodeSet->addNode(dataType);
-            } else if (xml.name().toString() == XmlTags::UAVariable) {
-                std::shared_ptr<UAVariable> variable = std::make_shared<UAVariable>();
-                parseUAVariable(xml, variable, nodeSet);
-                nodeSet->addNode(variable);
-            } else if (xml.name().toString() == XmlTags::UAMethod) {
-                std::shared_ptr<UAMethod> method = std::make_shared<UAMethod>();
-                parseUAMethod(xml, method, nodeSet);
-                nodeSet->addNode(method);
-            } else if (xml.name().toString() == XmlTags::UAVariableType) {
-                std::shared_ptr<UAVariableType> variableType = std::make_shared<UAVariableType>();
-                parseUAVariableType(xml, variableType, nodeSet);
-                nodeSet->addNode(variableType);
-            } else if (xml.name().toString() == XmlTags::UAObjectType) {
-                std::shared_ptr<UAObjectType> objectType = std::make_shared<UAObjectType>();
-                parseUAObjectType(xml, objectType, nodeSet);
-                nodeSet->addNode(objectType);
-            } else if (xml.name().toString() == XmlTags::Aliases) {
+                break;
+            case Token::UAObject:
+            case Token::UADataType:
+            case Token::UAVariable:
+            case Token::UAMethod:
+            case Token::UAVariableType:
+            case Token::UAObjectType:
+            case Token::UAReferenceType:
+                nodeSet->addNode(parseNode(xml, token, nodeSet));
+                break;
+            case Token::Aliases:
                 parseAliases(xml, nodeSet);
+                break;
+            default:
+                break;
             }
-        } else if (xml.isEndElement() && xml.name().toString() == XmlTags::UANodeSet) {
+        } else if (xml.isEndElement() && XmlTags::token(xml.name()) == Token::UANodeSet) {
             break;
         }
     }
 }
 
+template<typename Reader>
+std::shared_ptr<UANode> UaNodeSetParser::parseNode(Reader& xml, Token token, UANodeSet* nodeSet)
+{
+    switch (token) {
+    case Token::UAObject: {
+        std::shared_ptr<UAObject> object = nodeSet->create<UAObject>();
+        parseUAObject(xml, object, nodeSet);
+        return object;
+    }
+    case Token::UADataType: {
+        nodeSet->setHasCustomTypes(true);
+        std::shared_ptr<UADataType> dataType = nodeSet->create<UADataType>();
+        parseUADataType(xml, dataType, nodeSet);
+        return dataType;
+    }
+    case Token::UAVariable: {
+        std::shared_ptr<UAVariable> variable = nodeSet->create<UAVariable>();
+        parseUAVariable(xml, variable, nodeSet);
+        return variable;
+    }
+    case Token::UAMethod: {
+        std::shared_ptr<UAMethod> method = nodeSet->create<UAMethod>();
+        parseUAMethod(xml, method, nodeSet);
+        return method;
+    }
+    case Token::UAVariableType: {
+        std::shared_ptr<UAVariableType> variableType = nodeSet->create<UAVariableType>();
+        parseUAVariableType(xml, variableType, nodeSet);
+        return variableType;
+    }
+    case Token::UAObjectType: {
+        std::shared_ptr<UAObjectType> objectType = nodeSet->create<UAObjectType>();
+        parseUAObjectType(xml, objectType, nodeSet);
+        return objectType;
+    }
+    case Token::UAReferenceType: {
+        std::shared_ptr<UAReferenceType> referenceType = nodeSet->create<UAReferenceType>();
+        parseUAReferenceType(xml, referenceType, nodeSet);
+        return referenceType;
+    }
+    default:
+        return nullptr;
+    }
+}
+
+template<typename Reader>
 void UaNodeSetParser::parseUAObject(
-    QXmlStreamReader& xml, std::shared_ptr<UAObject> object, UANodeSet* nodeSet)
+    Reader& xml, std::shared_ptr<UAObject> object, UANodeSet* nodeSet)
 {
-    object->setNodeId(xml.attributes().value(XmlTags::NodeId).toString());
-    object->setBrowseName(xml.attributes().value(XmlTags::BrowseName).toString());
-    object->setBaseBrowseName(xml.attributes().value(XmlTags::BrowseName).toString());
-    object->setDescription(xml.attributes().value(XmlTags::Description).toString());
-    object->setParentNodeId(xml.attributes().value(XmlTags::ParentNodeId).toString());
-    object->setNamespaceString(nodeSet->getNameSpaceUri());
+    applyNodeAttributes(readNodeAttributes(xml), object, nodeSet);
 
     parseDisplayName(xml, object);
     parseReferences(xml, object, nodeSet);
 }
 
+template<typename Reader>
 void UaNodeSetParser::parseUADataType(
-    QXmlStreamReader& xml, std::shared_ptr<UADataType> dataType, UANodeSet* nodeSet)
+    Reader& xml, std::shared_ptr<UADataType> dataType, UANodeSet* nodeSet)
 {
-    dataType->setNodeId(xml.attributes().value(XmlTags::NodeId).toString());
+    const NodeAttributes attributes = readNodeAttributes(xml);
+    applyNodeAttributes(attributes, dataType, nodeSet);
     // setting the DefinitionName to BrowseName since base datatypes have no Definition Tag.
-    dataType->setDefinitionName(xml.attributes().value(XmlTags::BrowseName).toString());
-    dataType->setBrowseName(xml.attributes().value(XmlTags::BrowseName).toString());
-    dataType->setBaseBrowseName(xml.attributes().value(XmlTags::BrowseName).toString());
-    dataType->setDescription(xml.attributes().value(XmlTags::Description).toString());
-    dataType->setParentNodeId(xml.attributes().value(XmlTags::ParentNodeId).toString());
-    dataType->setNamespaceString(nodeSet->getNameSpaceUri());
+    dataType->setDefinitionName(attributes.browseName);
     parseDisplayName(xml, dataType);
     parseReferences(xml, dataType, nodeSet);
 
@@ -115,153 +560,184 @@ void UaNodeSetParser::parseUADataType(
     while (!xml.atEnd()) {
         xml.readNext();
         if (xml.isStartElement()) {
-            if (xml.name().toString() == XmlTags::Definition) {
+            if (XmlTags::token(xml.name()) == Token::Definition) {
                 // overwrite definition name if the datatype has a Definiton Tag
                 dataType->setDefinitionName(xml.attributes().value(XmlTags::Name).toString());
                 while (!xml.atEnd()) {
                     xml.readNext();
-                    if (xml.isStartElement() && xml.name().toString() == XmlTags::Field) {
+                    if (xml.isStartElement() && XmlTags::token(xml.name()) == Token::Field) {
                         // To distinguish between enums and other types, we check if the value is set.
                         // a value represents the enum index. If there is no value, we have a normal datatype.
-                        QString value = xml.attributes().value(XmlTags::Value).toString();
-                        if (value != QStringLiteral("")) {
+                        using Text = decltype(xml.attributes().value(XmlTags::Name));
+                        Text name;
+                        Text value;
+                        Text fieldDataType;
+                        const auto& fieldAttributes = xml.attributes();
+                        for (const auto& attribute : fieldAttributes) {
+                            switch (XmlTags::token(attribute.name())) {
+                            case Token::Name:
+                                name = attribute.value();
+                                break;
+                            case Token::Value:
+                                value = attribute.value();
+                                break;
+                            case Token::DataType:
+                                fieldDataType = attribute.value();
+                                break;
+                            default:
+                                break;
+                            }
+                        }
+                        if (!value.isEmpty()) {
                             dataType->setIsEnum(true);
-                            dataType->addDefinitionField(
-                                xml.attributes().value(XmlTags::Name).toString(), value);
+                            dataType->addDefinitionField(name.toString(), value.toString());
                         } else {
-                            dataType->addDefinitionField(
-                                xml.attributes().value(XmlTags::Name).toString(),
-                                xml.attributes().value(XmlTags::DataType).toString());
+                            dataType->addDefinitionField(name.toString(), fieldDataType.toString());
                         }
 
-                    } else if (xml.isEndElement() && xml.name().toString() == XmlTags::Definition) {
+                    } else if (
+                        xml.isEndElement() && XmlTags::token(xml.name()) == Token::Definition) {
                         break;
                     }
                 }
             }
-        } else if (xml.isEndElement() && xml.name().toString() == XmlTags::UADataType) {
+        } else if (xml.isEndElement() && XmlTags::token(xml.name()) == Token::UADataType) {
             break;
         }
     }
 }
 
+template<typename Reader>
 void UaNodeSetParser::parseUAVariable(
-    QXmlStreamReader& xml, std::shared_ptr<UAVariable> variable, UANodeSet* nodeSet)
+    Reader& xml, std::shared_ptr<UAVariable> variable, UANodeSet* nodeSet)
 {
-    variable->setNodeId(xml.attributes().value(XmlTags::NodeId).toString());
-    variable->setBrowseName(xml.attributes().value(XmlTags::BrowseName).toString());
-    variable->setBaseBrowseName(xml.attributes().value(XmlTags::BrowseName).toString());
-    variable->setDescription(xml.attributes().value(XmlTags::Description).toString());
+    const NodeAttributes attributes = readNodeAttributes(xml);
+    applyNodeAttributes(attributes, variable, nodeSet);
     UADataType dataType;
-    dataType.setDefinitionName(xml.attributes().value(XmlTags::DataType).toString());
-    variable->setDataType(dataType);
-    variable->setParentNodeId(xml.attributes().value(XmlTags::ParentNodeId).toString());
-    variable->setValueRank(xml.attributes().value(XmlTags::ValueRank).toInt());
-    variable->setArrayDimensions(xml.attributes().value(XmlTags::ArrayDimensions).toInt());
-    variable->setNamespaceString(nodeSet->getNameSpaceUri());
+    dataType.setDefinitionName(attributes.dataType);
+    variable->setDataType(std::move(dataType));
+    variable->setValueRank(attributes.valueRank);
+    variable->setArrayDimensions(attributes.arrayDimensions);
 
     parseDisplayName(xml, variable);
     parseReferences(xml, variable, nodeSet);
 
     QVector<Argument> arguments;
+    UAValue value;
 
     while (!xml.atEnd()) {
         xml.readNext();
         if (xml.isStartElement()) {
-            if (xml.name().toString() == QStringLiteral("Value")) {
-                parseListOfExtensionObject(xml, arguments);
+            if (XmlTags::token(xml.name()) == Token::Value) {
+                parseValue(xml, arguments, value);
             }
-        } else if (xml.isEndElement() && xml.name().toString() == XmlTags::UAVariable) {
+        } else if (xml.isEndElement() && XmlTags::token(xml.name()) == Token::UAVariable) {
             break;
         }
     }
 
-    variable->setArguments(arguments);
+    variable->setArguments(std::move(arguments));
+    variable->setValue(std::move(value));
 }
 
+template<typename Reader>
 void UaNodeSetParser::parseUAMethod(
-    QXmlStreamReader& xml, std::shared_ptr<UAMethod> method, UANodeSet* nodeSet)
+    Reader& xml, std::shared_ptr<UAMethod> method, UANodeSet* nodeSet)
 {
-    method->setNodeId(xml.attributes().value(XmlTags::NodeId).toString());
-    method->setBrowseName(xml.attributes().value(XmlTags::BrowseName).toString());
-    method->setBaseBrowseName(xml.attributes().value(XmlTags::BrowseName).toString());
-    method->setDescription(xml.attributes().value(XmlTags::Description).toString());
-    method->setParentNodeId(xml.attributes().value(XmlTags::ParentNodeId).toString());
-    method->setNamespaceString(nodeSet->getNameSpaceUri());
+    applyNodeAttributes(readNodeAttributes(xml), method, nodeSet);
 
     parseDisplayName(xml, method);
     parseReferences(xml, method, nodeSet);
 }
 
+template<typename Reader>
 void UaNodeSetParser::parseUAVariableType(
-    QXmlStreamReader& xml, std::shared_ptr<UAVariableType> variableType, UANodeSet* nodeSet)
+    Reader& xml, std::shared_ptr<UAVariableType> variableType, UANodeSet* nodeSet)
 {
-    variableType->setNodeId(xml.attributes().value(XmlTags::NodeId).toString());
-    variableType->setBrowseName(xml.attributes().value(XmlTags::BrowseName).toString());
-    variableType->setBaseBrowseName(xml.attributes().value(XmlTags::BrowseName).toString());
-    variableType->setDescription(xml.attributes().value(XmlTags::Description).toString());
-    variableType->setParentNodeId(xml.attributes().value(XmlTags::ParentNodeId).toString());
-    variableType->setIsAbstract(
-        xml.attributes().value(XmlTags::IsAbstract).toString() == QStringLiteral("true"));
-    variableType->setNamespaceString(nodeSet->getNameSpaceUri());
+    const NodeAttributes attributes = readNodeAttributes(xml);
+    applyNodeAttributes(attributes, variableType, nodeSet);
+    variableType->setIsAbstract(attributes.isAbstract);
 
     parseDisplayName(xml, variableType);
     parseReferences(xml, variableType, nodeSet);
 }
 
+template<typename Reader>
 void UaNodeSetParser::parseUAObjectType(
-    QXmlStreamReader& xml, std::shared_ptr<UAObjectType> objectType, UANodeSet* nodeSet)
+    Reader& xml, std::shared_ptr<UAObjectType> objectType, UANodeSet* nodeSet)
 {
-    objectType->setNodeId(xml.attributes().value(XmlTags::NodeId).toString());
-    objectType->setBrowseName(xml.attributes().value(XmlTags::BrowseName).toString());
-    objectType->setBaseBrowseName(xml.attributes().value(XmlTags::BrowseName).toString());
-    objectType->setDescription(xml.attributes().value(XmlTags::Description).toString());
-    objectType->setParentNodeId(xml.attributes().value(XmlTags::ParentNodeId).toString());
-    objectType->setIsAbstract(
-        xml.attributes().value(XmlTags::IsAbstract).toString() == QStringLiteral("true"));
-    objectType->setNamespaceString(nodeSet->getNameSpaceUri());
+    const NodeAttributes attributes = readNodeAttributes(xml);
+    applyNodeAttributes(attributes, objectType, nodeSet);
+    objectType->setIsAbstract(attributes.isAbstract);
 
     parseDisplayName(xml, objectType);
     parseReferences(xml, objectType, nodeSet);
 }
 
-void UaNodeSetParser::parseReferences(
-    QXmlStreamReader& xml, std::shared_ptr<UANode> node, UANodeSet* nodeSet)
+template<typename Reader>
+void UaNodeSetParser::parseUAReferenceType(
+    Reader& xml, std::shared_ptr<UAReferenceType> referenceType, UANodeSet* nodeSet)
+{
+    const NodeAttributes attributes = readNodeAttributes(xml);
+    applyNodeAttributes(attributes, referenceType, nodeSet);
+    referenceType->setIsAbstract(attributes.isAbstract);
+
+    parseDisplayName(xml, referenceType);
+    parseReferences(xml, referenceType, nodeSet);
+}
+
+template<typename Reader>
+void UaNodeSetParser::parseReferences(Reader& xml, std::shared_ptr<UANode> node, UANodeSet* nodeSet)
 {
     while (!xml.atEnd()) {
         xml.readNext();
         if (xml.isStartElement()) {
-            if (xml.name().toString() == XmlTags::Reference) {
-                QString referenceType = xml.attributes().value(XmlTags::ReferenceType).toString();
-                bool isForward = xml.attributes().value(XmlTags::IsForward).toString().length() > 0
-                                     ? false
-                                     : true;
+            if (XmlTags::token(xml.name()) == Token::Reference) {
+                QString referenceType;
+                bool isForward = true;
+                const auto& attributes = xml.attributes();
+                for (const auto& attribute : attributes) {
+                    switch (XmlTags::token(attribute.name())) {
+                    case Token::ReferenceType:
+                        referenceType = attribute.value().toString();
+                        break;
+                    case Token::IsForward:
+                        isForward = attribute.value().isEmpty();
+                        break;
+                    default:
+                        break;
+                    }
+                }
                 QString targetId = xml.readElementText();
+                std::shared_ptr<Reference> reference = nodeSet->create<Reference>(
+                    referenceType, targetId, isForward);
                 QString nameSpaceString = nodeSet->getNamespaceUriByIndex(
-                    Utils::instance()->extractNamespaceIndex(targetId));
+                    reference->targetId().namespaceIndex());
 
                 if (nameSpaceString.isEmpty()) {
                     qWarning() << "NamespaceString not found for targetId" << targetId;
                 }
-                node->addReference(
-                    std::make_shared<Reference>(referenceType, targetId, isForward, nameSpaceString));
+                reference->setNamespaceString(nameSpaceString);
+                node->addReference(reference);
             }
-        } else if (xml.isEndElement() && xml.name().toString() == XmlTags::References) {
+        } else if (xml.isEndElement() && XmlTags::token(xml.name()) == Token::References) {
             break;
         }
     }
 }
 
-void UaNodeSetParser::parseNamespaceMappping(QXmlStreamReader& xml, UANodeSet* nodeSet)
+template<typename Reader>
+void UaNodeSetParser::parseNamespaceMappping(Reader& xml, UANodeSet* nodeSet)
 {
     // we start from the second namespace index, because the first two namespaces are already mapped for the own namespace and the UA namespace
     int namespaceIndex = 2;
     while (!xml.atEnd()) {
         xml.readNext();
         if (xml.isStartElement()) {
+            const Token token = XmlTags::token(xml.name());
             //RequiredModel is the URI of the required Companion Specification
-            if (xml.name().toString() == XmlTags::RequiredModel) {
-                QXmlStreamAttributes attributes = xml.attributes();
+            if (token == Token::RequiredModel) {
+                const auto& attributes = xml.attributes();
                 if (attributes.hasAttribute(XmlTags::ModelUri)) {
                     QString modelUri = attributes.value(XmlTags::ModelUri).toString();
                     if (modelUri == QStringLiteral("http://opcfoundation.org/UA/")) {
@@ -272,8 +748,8 @@ void UaNodeSetParser::parseNamespaceMappping(QXmlStreamReader& xml, UANodeSet* n
                     }
                 }
                 // "Model" is the URI of the selected Companion Specification
-            } else if (xml.name().toString() == XmlTags::Model) {
-                QXmlStreamAttributes attributes = xml.attributes();
+            } else if (token == Token::Model) {
+                const auto& attributes = xml.attributes();
                 if (attributes.hasAttribute(XmlTags::ModelUri)) {
                     QString modelUri = attributes.value(XmlTags::ModelUri).toString();
                     // special case for the map to work. The UA namespace is always the first namespace
@@ -286,132 +762,239 @@ void UaNodeSetParser::parseNamespaceMappping(QXmlStreamReader& xml, UANodeSet* n
                     }
                 }
             }
-        } else if (xml.isEndElement() && xml.name().toString() == XmlTags::Models) {
+        } else if (xml.isEndElement() && XmlTags::token(xml.name()) == Token::Models) {
             break;
         }
     }
 }
 
-void UaNodeSetParser::parseAliases(QXmlStreamReader& xml, UANodeSet* nodeSet)
+template<typename Reader>
+void UaNodeSetParser::parseAliases(Reader& xml, UANodeSet* nodeSet)
 {
     while (!xml.atEnd()) {
         xml.readNext();
         if (xml.isStartElement()) {
-            if (xml.name().toString() == XmlTags::Alias) {
+            if (XmlTags::token(xml.name()) == Token::Alias) {
                 QString alias = xml.attributes().value(XmlTags::Alias).toString();
                 QString target = xml.readElementText();
                 nodeSet->addAlias(alias, target);
             }
-        } else if (xml.isEndElement() && xml.name().toString() == XmlTags::Aliases) {
+        } else if (xml.isEndElement() && XmlTags::token(xml.name()) == Token::Aliases) {
             break;
         }
     }
 }
 
-void UaNodeSetParser::parseDisplayName(QXmlStreamReader& xml, std::shared_ptr<UANode> node)
+template<typename Reader>
+void UaNodeSetParser::parseDisplayName(Reader& xml, std::shared_ptr<UANode> node)
 {
     while (!xml.atEnd()) {
         xml.readNext();
         if (xml.isStartElement()) {
-            if (xml.name().toString() == XmlTags::DisplayName) {
+            if (XmlTags::token(xml.name()) == Token::DisplayName) {
                 node->setDisplayName(xml.readElementText());
                 break;
             }
-        } else if (xml.isEndElement() && xml.name().toString() == XmlTags::DisplayName) {
+        } else if (xml.isEndElement() && XmlTags::token(xml.name()) == Token::DisplayName) {
+            break;
+        }
+    }
+}
+
+template<typename Reader>
+void UaNodeSetParser::skipElement(Reader& xml)
+{
+    int depth = 1;
+    while (depth > 0 && !xml.atEnd()) {
+        xml.readNext();
+        if (xml.isStartElement())
+            ++depth;
+        else if (xml.isEndElement())
+            --depth;
+    }
+}
+
+template<typename Reader>
+void UaNodeSetParser::parseValue(Reader& xml, QVector<Argument>& arguments, UAValue& value)
+{
+    while (!xml.atEnd()) {
+        xml.readNext();
+        if (xml.isStartElement()) {
+            if (XmlTags::token(xml.name()) == Token::ListOfExtensionObject) {
+                parseListOfExtensionObject(xml, arguments);
+            } else {
+                value = parseBuiltInValue(xml);
+            }
+        } else if (xml.isEndElement() && XmlTags::token(xml.name()) == Token::Value) {
             break;
         }
     }
 }
 
-void UaNodeSetParser::parseListOfExtensionObject(QXmlStreamReader& xml, QVector<Argument>& arguments)
+// Reads a built-in scalar like <Int32> or an array like <ListOfInt32>. Values of other types,
+// e.g. a single <ExtensionObject>, are skipped and give a Null value.
+template<typename Reader>
+UAValue UaNodeSetParser::parseBuiltInValue(Reader& xml)
 {
+    const QString name = elementName(xml.name());
+    const bool isArray = name.startsWith(QStringLiteral("ListOf"));
+    const QStringView typeName = isArray ? QStringView(name).sliced(6) : QStringView(name);
+    UAValue value(UAValue::typeFromName(typeName), isArray);
+    if (value.isNull() || value.type() == UAValue::Type::XmlElement) {
+        if (!m_skippedValueTypes.contains(name)) {
+            m_skippedValueTypes.insert(name);
+            qDebug() << "Skipping values of unsupported type" << name;
+        }
+        skipElement(xml);
+        return UAValue();
+    }
+
+    if (!isArray) {
+        parseValueElement(xml, value);
+        return value;
+    }
     while (!xml.atEnd()) {
         xml.readNext();
         if (xml.isStartElement()) {
-            if (xml.name().toString() == QStringLiteral("ListOfExtensionObject")) {
-                while (!xml.atEnd()) {
-                    xml.readNext();
-                    if (xml.isStartElement()) {
-                        if (xml.name().toString() == QStringLiteral("ExtensionObject")) {
-                            arguments.append(parseExtensionObject(xml));
-                        }
-                    } else if (
-                        xml.isEndElement()
-                        && xml.name().toString() == QStringLiteral("ListOfExtensionObject")) {
-                        break;
-                    }
-                }
-            } else if (
-                xml.isEndElement()
-                && xml.name().toString() == QStringLiteral("ListOfExtensionObject")) {
-                break;
+            parseValueElement(xml, value);
+        } else if (xml.isEndElement()) {
+            // the end elements of the items are read by parseValueElement
+            break;
+        }
+    }
+    return value;
+}
+
+template<typename Reader>
+void UaNodeSetParser::parseValueElement(Reader& xml, UAValue& value)
+{
+    const UAValue::Type type = value.type();
+    const bool isPair = type == UAValue::Type::LocalizedText
+                        || type == UAValue::Type::QualifiedName;
+    // Guid, NodeId, ExpandedNodeId and StatusCode wrap their text in a single child element
+    const bool isWrapped = type == UAValue::Type::Guid || type == UAValue::Type::NodeId
+                           || type == UAValue::Type::ExpandedNodeId
+                           || type == UAValue::Type::StatusCode;
+
+    if (!isPair && !isWrapped) {
+        const QString text = xml.readElementText();
+        if (!value.appendText(text))
+            qWarning() << "Invalid" << value.cTypeName() << "value:" << text;
+        return;
+    }
+
+    QString first;
+    QString second;
+    while (!xml.atEnd()) {
+        xml.readNext();
+        if (xml.isStartElement()) {
+            const QString field = elementName(xml.name());
+            if (isWrapped || field == QStringLiteral("Locale")
+                || field == QStringLiteral("NamespaceIndex")) {
+                first = xml.readElementText();
+            } else if (field == QStringLiteral("Text") || field == QStringLiteral("Name")) {
+                second = xml.readElementText();
+            } else {
+                skipElement(xml);
+            }
+        } else if (xml.isEndElement()) {
+            break;
+        }
+    }
+
+    if (isPair) {
+        value.appendPair(first, second);
+    } else if (!value.appendText(first)) {
+        qWarning() << "Invalid" << value.cTypeName() << "value:" << first;
+    }
+}
+
+template<typename Reader>
+void UaNodeSetParser::parseListOfExtensionObject(Reader& xml, QVector<Argument>& arguments)
+{
+    while (!xml.atEnd()) {
+        xml.readNext();
+        if (xml.isStartElement()) {
+            if (XmlTags::token(xml.name()) == Token::ExtensionObject) {
+                arguments.append(parseExtensionObject(xml));
             }
-        } else if (xml.isEndElement() && xml.name().toString() == QStringLiteral("Value")) {
+        } else if (
+            xml.isEndElement() && XmlTags::token(xml.name()) == Token::ListOfExtensionObject) {
             break;
         }
     }
 }
 
-Argument UaNodeSetParser::parseExtensionObject(QXmlStreamReader& xml)
+template<typename Reader>
+Argument UaNodeSetParser::parseExtensionObject(Reader& xml)
 {
     Argument arg;
     while (!xml.atEnd()) {
         xml.readNext();
         if (xml.isStartElement()) {
-            if (xml.name().toString() == QStringLiteral("TypeId")) {
+            const Token token = XmlTags::token(xml.name());
+            if (token == Token::TypeId) {
                 parseTypeId(xml, arg);
-            }
-            if (xml.name().toString() == QStringLiteral("Body")) {
+            } else if (token == Token::Body) {
                 parseArgument(xml, arg);
             }
-        } else if (xml.isEndElement() && xml.name().toString() == QStringLiteral("ExtensionObject")) {
+        } else if (xml.isEndElement() && XmlTags::token(xml.name()) == Token::ExtensionObject) {
             return arg;
         }
     }
     return arg;
 }
 
-void UaNodeSetParser::parseArgument(QXmlStreamReader& xml, Argument& arg)
+template<typename Reader>
+void UaNodeSetParser::parseArgument(Reader& xml, Argument& arg)
 {
     while (!xml.atEnd()) {
         xml.readNext();
         if (xml.isStartElement()) {
-            if (xml.name().toString() == QStringLiteral("Name")) {
+            switch (XmlTags::token(xml.name())) {
+            case Token::Name:
                 arg.name = xml.readElementText();
-            } else if (xml.name().toString() == QStringLiteral("DataType")) {
+                break;
+            case Token::DataType:
                 parseDataType(xml, arg);
-            } else if (xml.name().toString() == QStringLiteral("ValueRank")) {
+                break;
+            case Token::ValueRank:
                 arg.valueRank = xml.readElementText().toInt();
+                break;
+            default:
+                break;
             }
-        } else if (xml.isEndElement() && xml.name().toString() == QStringLiteral("Body")) {
+        } else if (xml.isEndElement() && XmlTags::token(xml.name()) == Token::Body) {
             break;
         }
     }
 }
 
-void UaNodeSetParser::parseDataType(QXmlStreamReader& xml, Argument& arg)
+template<typename Reader>
+void UaNodeSetParser::parseDataType(Reader& xml, Argument& arg)
 {
     while (!xml.atEnd()) {
         xml.readNext();
         if (xml.isStartElement()) {
-            if (xml.name().toString() == QStringLiteral("Identifier")) {
+            if (XmlTags::token(xml.name()) == Token::Identifier) {
                 arg.dataTypeIdentifier = xml.readElementText();
             }
-        } else if (xml.isEndElement() && xml.name().toString() == QStringLiteral("DataType")) {
+        } else if (xml.isEndElement() && XmlTags::token(xml.name()) == Token::DataType) {
             break;
         }
     }
 }
 
-void UaNodeSetParser::parseTypeId(QXmlStreamReader& xml, Argument& arg)
+template<typename Reader>
+void UaNodeSetParser::parseTypeId(Reader& xml, Argument& arg)
 {
     while (!xml.atEnd()) {
         xml.readNext();
         if (xml.isStartElement()) {
-            if (xml.name().toString() == QStringLiteral("Identifier")) {
+            if (XmlTags::token(xml.name()) == Token::Identifier) {
                 arg.dataTypeIdentifier = xml.readElementText();
             }
-        } else if (xml.isEndElement() && xml.name().toString() == QStringLiteral("TypeId")) {
+        } else if (xml.isEndElement() && XmlTags::token(xml.name()) == Token::TypeId) {
             break;
         }
     }
@@ -7,43 +7,121 @@
 #ifndef UANODESETPARSER_H
 #define UANODESETPARSER_H
 
+#include "nodesettokenizer.h"
 #include "uanode.h"
 #include "uanodeset.h"
 #include <QDebug>
 #include <QFile>
+#include <QSet>
+#include <QStringList>
 #include <QXmlStreamReader>
 
 class UaNodeSetParser
 {
 public:
+    // The Models block of a NodeSet2.xml file.
+    struct ModelHeader
+    {
+        // URI of the last Model element, the companion specification defined by the file
+        QString modelUri;
+        QString version;
+        QString publicationDate;
+        // ModelUris of all RequiredModel and Model elements in document order
+        QStringList modelUris;
+    };
+
     UaNodeSetParser();
+
+    // Reads only up to </Models>. The result is cached per file until its size or
+    // modification time changes. Thread safe.
+    static ModelHeader readModelHeader(const QString& filePath);
+
     bool parse(const QString& filePath, UANodeSet* nodeSet);
+    // Only records NodeId, node class and byte offset of every node element. The nodes are parsed
+    // on first access through the UANodeSet.
+    bool index(const QString& filePath, UANodeSet* nodeSet);
+
+    // Parse from a memory mapping of the file instead of reading it through QIODevice (default).
+    void setUseMemoryMap(bool useMemoryMap);
+    // Tokenize mapped files with NodeSetTokenizer instead of QXmlStreamReader (default). Files the
+    // tokenizer can't handle are parsed again with QXmlStreamReader.
+    void setUseFastTokenizer(bool useFastTokenizer);
 
 private:
-    QFile m_file;
-
-    void parseNodeSet(QXmlStreamReader& xml, UANodeSet* nodeSet);
-    void parseUAObject(QXmlStreamReader& xml, std::shared_ptr<UAObject> object, UANodeSet* nodeSet);
-    void parseUADataType(
-        QXmlStreamReader& xml, std::shared_ptr<UADataType> dataType, UANodeSet* nodeSet);
-    void parseUAVariable(
-        QXmlStreamReader& xml, std::shared_ptr<UAVariable> variable, UANodeSet* nodeSet);
-    void parseUAMethod(QXmlStreamReader& xml, std::shared_ptr<UAMethod> method, UANodeSet* nodeSet);
+    bool m_useMemoryMap = true;
+    bool m_useFastTokenizer = true;
+    // value types that were skipped, each is logged once per file
+    QSet<QString> m_skippedValueTypes;
+
+    // Attributes shared by all UA* node elements, read in a single pass over the attribute list.
+    struct NodeAttributes
+    {
+        QString nodeId;
+        QString browseName;
+        QString description;
+        QString parentNodeId;
+        QString dataType;
+        int valueRank = 0;
+        int arrayDimensions = 0;
+        bool isAbstract = false;
+    };
+
+    template<typename Reader>
+    NodeAttributes readNodeAttributes(Reader& xml);
+    void applyNodeAttributes(
+        const NodeAttributes& attributes, std::shared_ptr<UANode> node, UANodeSet* nodeSet);
+
+    template<typename Reader>
+    bool parseDocument(Reader& xml, UANodeSet* nodeSet);
+    template<typename Reader>
+    void parseNodeSet(Reader& xml, UANodeSet* nodeSet);
+    template<typename Reader>
+    std::shared_ptr<UANode> parseNode(Reader& xml, XmlTags::Token token, UANodeSet* nodeSet);
+    template<typename Reader>
+    void parseUAObject(Reader& xml, std::shared_ptr<UAObject> object, UANodeSet* nodeSet);
+    template<typename Reader>
+    void parseUADataType(Reader& xml, std::shared_ptr<UADataType> dataType, UANodeSet* nodeSet);
+    template<typename Reader>
+    void parseUAVariable(Reader& xml, std::shared_ptr<UAVariable> variable, UANodeSet* nodeSet);
+    template<typename Reader>
+    void parseUAMethod(Reader& xml, std::shared_ptr<UAMethod> method, UANodeSet* nodeSet);
+    template<typename Reader>
     void parseUAVariableType(
-        QXmlStreamReader& xml, std::shared_ptr<UAVariableType> variableType, UANodeSet* nodeSet);
+        Reader& xml, std::shared_ptr<UAVariableType> variableType, UANodeSet* nodeSet);
+    template<typename Reader>
     void parseUAObjectType(
-        QXmlStreamReader& xml, std::shared_ptr<UAObjectType> objectType, UANodeSet* nodeSet);
-    void parseReferences(QXmlStreamReader& xml, std::shared_ptr<UANode> node, UANodeSet* nodeSet);
-    void parseNamespaceMappping(QXmlStreamReader& xml, UANodeSet* nodeSet);
-    void parseAliases(QXmlStreamReader& xml, UANodeSet* nodeSet);
-    void parseDisplayName(QXmlStreamReader& xml, std::shared_ptr<UANode> node);
+        Reader& xml, std::shared_ptr<UAObjectType> objectType, UANodeSet* nodeSet);
+    template<typename Reader>
+    void parseUAReferenceType(
+        Reader& xml, std::shared_ptr<UAReferenceType> referenceType, UANodeSet* nodeSet);
+    template<typename Reader>
+    void parseReferences(Reader& xml, std::shared_ptr<UANode> node, UANodeSet* nodeSet);
+    template<typename Reader>
+    void parseNamespaceMappping(Reader& xml, UANodeSet* nodeSet);
+    template<typename Reader>
+    void parseAliases(Reader& xml, UANodeSet* nodeSet);
+    template<typename Reader>
+    void parseDisplayName(Reader& xml, std::shared_ptr<UANode> node);
 
     bool findElement(QXmlStreamReader& xml, const QString& elementName);
-    void parseListOfExtensionObject(QXmlStreamReader& xml, QVector<Argument>& arguments);
-    Argument parseExtensionObject(QXmlStreamReader& xml);
-    void parseArgument(QXmlStreamReader& xml, Argument& arg);
-    void parseDataType(QXmlStreamReader& xml, Argument& arg);
-    void parseTypeId(QXmlStreamReader& xml, Argument& arg);
+    template<typename Reader>
+    void skipElement(Reader& xml);
+    template<typename Reader>
+    void parseValue(Reader& xml, QVector<Argument>& arguments, UAValue& value);
+    template<typename Reader>
+    UAValue parseBuiltInValue(Reader& xml);
+    template<typename Reader>
+    void parseValueElement(Reader& xml, UAValue& value);
+    template<typename Reader>
+    void parseListOfExtensionObject(Reader& xml, QVector<Argument>& arguments);
+    template<typename Reader>
+    Argument parseExtensionObject(Reader& xml);
+    template<typename Reader>
+    void parseArgument(Reader& xml, Argument& arg);
+    template<typename Reader>
+    void parseDataType(Reader& xml, Argument& arg);
+    template<typename Reader>
+    void parseTypeId(Reader& xml, Argument& arg);
 };
 
 #endif // UANODESETPARSER_H
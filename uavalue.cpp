@@ -0,0 +1,481 @@
+// SPDX-FileCopyrightText: 2025 Marius Dege <marius.dege@basyskom.com>
+// SPDX-FileCopyrightText: 2024 Marius Dege <marius.dege@basyskom.com>
+// SPDX-FileCopyrightText: 2024 basysKom GmbH
+
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "uavalue.h"
+#include <QDateTime>
+#include <QUuid>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace {
+
+// indexed by UAValue::Type
+constexpr const char* TypeNames[] = {
+    "Null", "Boolean", "SByte", "Byte", "Int16", "UInt16", "Int32", "UInt32", "Int64", "UInt64",
+    "Float", "Double", "String", "DateTime", "Guid", "ByteString", "XmlElement", "NodeId",
+    "ExpandedNodeId", "StatusCode", "QualifiedName", "LocalizedText",
+};
+
+// 100 ns ticks between 1601-01-01, the UA_DateTime epoch, and 1970-01-01
+constexpr qint64 UnixEpochTicks = 116444736000000000LL;
+
+template<typename T>
+void appendRaw(QByteArray& bytes, T value)
+{
+    bytes.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template<typename T>
+T readRaw(const QByteArray& bytes, qsizetype index)
+{
+    T value;
+    std::memcpy(&value, bytes.constData() + index * sizeof(T), sizeof(T));
+    return value;
+}
+
+// C string literal, everything but printable ASCII is written as an octal escape
+QString cStringLiteral(const QByteArray& bytes)
+{
+    QString literal;
+    literal.reserve(bytes.size() + 2);
+    literal.append(QLatin1Char('"'));
+    for (const char c : bytes) {
+        const uchar byte = static_cast<uchar>(c);
+        if (byte >= 0x20 && byte < 0x7F && c != '"' && c != '\\' && c != '?') {
+            literal.append(QLatin1Char(c));
+        } else {
+            literal.append(QStringLiteral("\\%1").arg(byte, 3, 8, QLatin1Char('0')));
+        }
+    }
+    literal.append(QLatin1Char('"'));
+    return literal;
+}
+
+QString staticString(const QString& string)
+{
+    return QStringLiteral("UA_STRING_STATIC(%1)").arg(cStringLiteral(string.toUtf8()));
+}
+
+// Keeps a decimal point, so the literal stays floating point
+QString floatingPointLiteral(double value, int precision)
+{
+    QString literal = QString::number(value, 'g', precision);
+    if (!literal.contains(QLatin1Char('.')) && !literal.contains(QLatin1Char('e')))
+        literal.append(QStringLiteral(".0"));
+    return literal;
+}
+
+} // namespace
+
+UAValue::UAValue(Type type, bool isArray)
+    : m_type(type)
+    , m_isArray(isArray)
+{}
+
+UAValue::Type UAValue::typeFromName(QStringView name)
+{
+    for (int i = int(Type::Boolean); i <= int(Type::LocalizedText); ++i) {
+        if (name == QLatin1StringView(TypeNames[i]))
+            return Type(i);
+    }
+    return Type::Null;
+}
+
+qsizetype UAValue::size() const
+{
+    if (isNumeric())
+        return m_isArray ? m_numbers.size() / elementSize() : qsizetype(m_hasScalar);
+    return m_strings.size() / partsPerElement();
+}
+
+bool UAValue::appendText(QStringView text)
+{
+    bool ok = false;
+    Scalar number{0};
+    const QStringView trimmed = text.trimmed();
+
+    switch (m_type) {
+    case Type::Null:
+    case Type::LocalizedText:
+    case Type::QualifiedName:
+        return false;
+    case Type::Boolean:
+        ok = trimmed == QLatin1StringView("true") || trimmed == QLatin1StringView("1")
+             || trimmed == QLatin1StringView("false") || trimmed == QLatin1StringView("0");
+        number.unsignedInteger = trimmed == QLatin1StringView("true")
+                                 || trimmed == QLatin1StringView("1");
+        break;
+    case Type::SByte:
+    case Type::Int16:
+    case Type::Int32:
+    case Type::Int64: {
+        number.integer = trimmed.toLongLong(&ok);
+        const int bits = int(elementSize()) * 8;
+        if (ok && bits < 64)
+            ok = number.integer >= -(qint64(1) << (bits - 1))
+                 && number.integer < (qint64(1) << (bits - 1));
+        break;
+    }
+    case Type::Byte:
+    case Type::UInt16:
+    case Type::UInt32:
+    case Type::UInt64:
+    case Type::StatusCode: {
+        number.unsignedInteger = trimmed.toULongLong(&ok);
+        const int bits = int(elementSize()) * 8;
+        if (ok && bits < 64)
+            ok = number.unsignedInteger < (quint64(1) << bits);
+        break;
+    }
+    case Type::Float:
+    case Type::Double:
+        number.floatingPoint = trimmed.toDouble(&ok);
+        break;
+    case Type::DateTime: {
+        const QDateTime dateTime = QDateTime::fromString(trimmed.toString(), Qt::ISODateWithMs);
+        ok = dateTime.isValid();
+        number.integer = dateTime.toMSecsSinceEpoch() * 10000 + UnixEpochTicks;
+        break;
+    }
+    case Type::Guid: {
+        const QUuid uuid(trimmed);
+        if (uuid.isNull() && trimmed != QLatin1StringView("00000000-0000-0000-0000-000000000000"))
+            return false;
+        if (!m_isArray)
+            m_strings.clear();
+        m_strings.append(uuid.toString(QUuid::WithoutBraces));
+        return true;
+    }
+    case Type::ByteString: {
+        QByteArray base64 = trimmed.toLatin1();
+        base64.replace('\n', QByteArray()).replace('\r', QByteArray()).replace(' ', QByteArray());
+        if (!QByteArray::fromBase64Encoding(base64, QByteArray::AbortOnBase64DecodingErrors))
+            return false;
+        if (!m_isArray)
+            m_strings.clear();
+        m_strings.append(QString::fromLatin1(base64));
+        return true;
+    }
+    case Type::NodeId:
+    case Type::ExpandedNodeId:
+        if (!m_isArray)
+            m_strings.clear();
+        m_strings.append(trimmed.toString());
+        return true;
+    case Type::String:
+    case Type::XmlElement:
+        if (!m_isArray)
+            m_strings.clear();
+        m_strings.append(text.toString());
+        return true;
+    }
+
+    if (ok)
+        appendNumber(number);
+    return ok;
+}
+
+void UAValue::appendPair(const QString& first, const QString& second)
+{
+    if (m_type != Type::LocalizedText && m_type != Type::QualifiedName)
+        return;
+    if (!m_isArray)
+        m_strings.clear();
+    m_strings.append(first);
+    m_strings.append(second);
+}
+
+qint64 UAValue::toInt64(qsizetype index) const
+{
+    const Scalar value = number(index);
+    return isFloatingPoint() ? qint64(value.floatingPoint) : value.integer;
+}
+
+quint64 UAValue::toUInt64(qsizetype index) const
+{
+    const Scalar value = number(index);
+    return isFloatingPoint() ? quint64(value.floatingPoint) : value.unsignedInteger;
+}
+
+double UAValue::toDouble(qsizetype index) const
+{
+    const Scalar value = number(index);
+    if (isFloatingPoint())
+        return value.floatingPoint;
+    return isUnsigned() ? double(value.unsignedInteger) : double(value.integer);
+}
+
+QString UAValue::string(qsizetype index, int part) const
+{
+    return m_strings.value(index * partsPerElement() + part);
+}
+
+QString UAValue::cTypeName() const
+{
+    return QStringLiteral("UA_") + QLatin1StringView(TypeNames[int(m_type)]);
+}
+
+QString UAValue::typesIndex() const
+{
+    return QStringLiteral("UA_TYPES_") + QString::fromLatin1(TypeNames[int(m_type)]).toUpper();
+}
+
+bool UAValue::hasStaticInitializer() const
+{
+    if (isNull() || size() == 0 || m_type == Type::NodeId || m_type == Type::ExpandedNodeId
+        || m_type == Type::QualifiedName)
+        return false;
+    if (isFloatingPoint()) {
+        for (qsizetype i = 0; i < size(); ++i) {
+            if (!std::isfinite(toDouble(i)))
+                return false;
+        }
+    }
+    return true;
+}
+
+QString UAValue::cInitializer() const
+{
+    if (!m_isArray)
+        return elementInitializer(0);
+
+    QStringList elements;
+    elements.reserve(size());
+    for (qsizetype i = 0; i < size(); ++i)
+        elements.append(elementInitializer(i));
+    return QStringLiteral("{") + elements.join(QStringLiteral(", ")) + QStringLiteral("}");
+}
+
+bool UAValue::operator==(const UAValue& other) const
+{
+    return m_type == other.m_type && m_isArray == other.m_isArray
+           && m_hasScalar == other.m_hasScalar
+           && m_scalar.unsignedInteger == other.m_scalar.unsignedInteger
+           && m_numbers == other.m_numbers && m_strings == other.m_strings;
+}
+
+QDataStream& operator<<(QDataStream& out, const UAValue& value)
+{
+    return out << quint8(value.m_type) << value.m_isArray << value.m_hasScalar
+               << value.m_scalar.unsignedInteger << value.m_numbers << value.m_strings;
+}
+
+QDataStream& operator>>(QDataStream& in, UAValue& value)
+{
+    quint8 type = 0;
+    in >> type >> value.m_isArray >> value.m_hasScalar >> value.m_scalar.unsignedInteger
+        >> value.m_numbers >> value.m_strings;
+    if (type > quint8(UAValue::Type::LocalizedText))
+        in.setStatus(QDataStream::ReadCorruptData);
+    value.m_type = UAValue::Type(type);
+    return in;
+}
+
+bool UAValue::isNumeric() const
+{
+    switch (m_type) {
+    case Type::Boolean:
+    case Type::SByte:
+    case Type::Byte:
+    case Type::Int16:
+    case Type::UInt16:
+    case Type::Int32:
+    case Type::UInt32:
+    case Type::Int64:
+    case Type::UInt64:
+    case Type::Float:
+    case Type::Double:
+    case Type::DateTime:
+    case Type::StatusCode:
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool UAValue::isUnsigned() const
+{
+    return m_type == Type::Boolean || m_type == Type::Byte || m_type == Type::UInt16
+           || m_type == Type::UInt32 || m_type == Type::UInt64 || m_type == Type::StatusCode;
+}
+
+bool UAValue::isFloatingPoint() const
+{
+    return m_type == Type::Float || m_type == Type::Double;
+}
+
+int UAValue::partsPerElement() const
+{
+    return m_type == Type::LocalizedText || m_type == Type::QualifiedName ? 2 : 1;
+}
+
+qsizetype UAValue::elementSize() const
+{
+    switch (m_type) {
+    case Type::Boolean:
+    case Type::SByte:
+    case Type::Byte:
+        return 1;
+    case Type::Int16:
+    case Type::UInt16:
+        return 2;
+    case Type::Int32:
+    case Type::UInt32:
+    case Type::Float:
+    case Type::StatusCode:
+        return 4;
+    default:
+        return 8;
+    }
+}
+
+void UAValue::appendNumber(Scalar number)
+{
+    if (!m_isArray) {
+        m_scalar = number;
+        m_hasScalar = true;
+        return;
+    }
+
+    switch (m_type) {
+    case Type::Boolean:
+    case Type::Byte:
+        appendRaw(m_numbers, quint8(number.unsignedInteger));
+        break;
+    case Type::SByte:
+        appendRaw(m_numbers, qint8(number.integer));
+        break;
+    case Type::Int16:
+        appendRaw(m_numbers, qint16(number.integer));
+        break;
+    case Type::UInt16:
+        appendRaw(m_numbers, quint16(number.unsignedInteger));
+        break;
+    case Type::Int32:
+        appendRaw(m_numbers, qint32(number.integer));
+        break;
+    case Type::UInt32:
+    case Type::StatusCode:
+        appendRaw(m_numbers, quint32(number.unsignedInteger));
+        break;
+    case Type::Float:
+        appendRaw(m_numbers, float(number.floatingPoint));
+        break;
+    case Type::Double:
+        appendRaw(m_numbers, number.floatingPoint);
+        break;
+    case Type::UInt64:
+        appendRaw(m_numbers, number.unsignedInteger);
+        break;
+    default:
+        appendRaw(m_numbers, number.integer);
+        break;
+    }
+}
+
+UAValue::Scalar UAValue::number(qsizetype index) const
+{
+    Scalar value{0};
+    if (!m_isArray) {
+        if (index == 0 && m_hasScalar)
+            value = m_scalar;
+        return value;
+    }
+    if (!isNumeric() || index < 0 || index >= size())
+        return value;
+
+    switch (m_type) {
+    case Type::Boolean:
+    case Type::Byte:
+        value.unsignedInteger = readRaw<quint8>(m_numbers, index);
+        break;
+    case Type::SByte:
+        value.integer = readRaw<qint8>(m_numbers, index);
+        break;
+    case Type::Int16:
+        value.integer = readRaw<qint16>(m_numbers, index);
+        break;
+    case Type::UInt16:
+        value.unsignedInteger = readRaw<quint16>(m_numbers, index);
+        break;
+    case Type::Int32:
+        value.integer = readRaw<qint32>(m_numbers, index);
+        break;
+    case Type::UInt32:
+    case Type::StatusCode:
+        value.unsignedInteger = readRaw<quint32>(m_numbers, index);
+        break;
+    case Type::Float:
+        value.floatingPoint = readRaw<float>(m_numbers, index);
+        break;
+    case Type::Double:
+        value.floatingPoint = readRaw<double>(m_numbers, index);
+        break;
+    case Type::UInt64:
+        value.unsignedInteger = readRaw<quint64>(m_numbers, index);
+        break;
+    default:
+        value.integer = readRaw<qint64>(m_numbers, index);
+        break;
+    }
+    return value;
+}
+
+QString UAValue::elementInitializer(qsizetype index) const
+{
+    switch (m_type) {
+    case Type::Boolean:
+        return toUInt64(index) ? QStringLiteral("true") : QStringLiteral("false");
+    case Type::SByte:
+    case Type::Int16:
+    case Type::Int32:
+        return QString::number(toInt64(index));
+    case Type::Int64:
+    case Type::DateTime: {
+        const qint64 value = toInt64(index);
+        // -9223372036854775808LL is the negation of a literal that does not fit
+        if (value == std::numeric_limits<qint64>::min())
+            return QStringLiteral("(-9223372036854775807LL - 1)");
+        return QString::number(value) + QStringLiteral("LL");
+    }
+    case Type::Byte:
+    case Type::UInt16:
+        return QString::number(toUInt64(index));
+    case Type::UInt32:
+        return QString::number(toUInt64(index)) + QStringLiteral("u");
+    case Type::UInt64:
+        return QString::number(toUInt64(index)) + QStringLiteral("ULL");
+    case Type::StatusCode:
+        return QStringLiteral("0x%1u").arg(toUInt64(index), 8, 16, QLatin1Char('0'));
+    case Type::Float:
+        return floatingPointLiteral(toDouble(index), 9) + QStringLiteral("f");
+    case Type::Double:
+        return floatingPointLiteral(toDouble(index), 17);
+    case Type::String:
+    case Type::XmlElement:
+        return staticString(string(index));
+    case Type::ByteString:
+        return QStringLiteral("UA_BYTESTRING_STATIC(%1)")
+            .arg(cStringLiteral(QByteArray::fromBase64(string(index).toLatin1())));
+    case Type::LocalizedText:
+        return QStringLiteral("{%1, %2}").arg(staticString(string(index, 0)),
+                                              staticString(string(index, 1)));
+    case Type::Guid: {
+        const QUuid uuid(string(index));
+        QStringList data4;
+        for (const uchar byte : uuid.data4)
+            data4.append(QStringLiteral("0x%1").arg(byte, 2, 16, QLatin1Char('0')));
+        return QStringLiteral("{0x%1, 0x%2, 0x%3, {%4}}")
+            .arg(uuid.data1, 8, 16, QLatin1Char('0'))
+            .arg(uuid.data2, 4, 16, QLatin1Char('0'))
+            .arg(uuid.data3, 4, 16, QLatin1Char('0'))
+            .arg(data4.join(QStringLiteral(", ")));
+    }
+    default:
+        return QString();
+    }
+}
@@ -0,0 +1,110 @@
+// SPDX-FileCopyrightText: 2025 Marius Dege <marius.dege@basyskom.com>
+// SPDX-FileCopyrightText: 2024 Marius Dege <marius.dege@basyskom.com>
+// SPDX-FileCopyrightText: 2024 basysKom GmbH
+
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#ifndef UAVALUE_H
+#define UAVALUE_H
+
+#include <QByteArray>
+#include <QDataStream>
+#include <QString>
+#include <QStringList>
+
+// Default value of a variable as given by the <Value> element of a NodeSet, for all built-in
+// types except ExtensionObject, Variant and DiagnosticInfo. Scalar numbers are stored inline,
+// array elements contiguously with their native size. Strings are kept in one list, with two
+// entries per element for LocalizedText (locale, text) and QualifiedName (namespace index, name).
+class UAValue
+{
+public:
+    enum class Type : quint8 {
+        Null,
+        Boolean,
+        SByte,
+        Byte,
+        Int16,
+        UInt16,
+        Int32,
+        UInt32,
+        Int64,
+        UInt64,
+        Float,
+        Double,
+        String,
+        DateTime,
+        Guid,
+        ByteString,
+        XmlElement,
+        NodeId,
+        ExpandedNodeId,
+        StatusCode,
+        QualifiedName,
+        LocalizedText,
+    };
+
+    UAValue() = default;
+    UAValue(Type type, bool isArray);
+
+    // Maps a built-in type name like "Int32" to its type, Null if there is none
+    static Type typeFromName(QStringView name);
+
+    Type type() const { return m_type; }
+    bool isNull() const { return m_type == Type::Null; }
+    bool isArray() const { return m_isArray; }
+    // number of elements, 1 for a scalar that has been set
+    qsizetype size() const;
+
+    // Appends an element given as the text of its XML element. Returns false if the text is not
+    // valid for the type, structured types are appended with the functions below.
+    bool appendText(QStringView text);
+    // LocalizedText (locale, text) and QualifiedName (namespace index, name)
+    void appendPair(const QString& first, const QString& second);
+
+    qint64 toInt64(qsizetype index = 0) const;
+    quint64 toUInt64(qsizetype index = 0) const;
+    double toDouble(qsizetype index = 0) const;
+    // part 1 is the second string of a LocalizedText or QualifiedName
+    QString string(qsizetype index = 0, int part = 0) const;
+
+    // C type and UA_TYPES index of the value in open62541
+    QString cTypeName() const;
+    QString typesIndex() const;
+    // Whether the value can be written as a constant C initialiser. NodeIds and QualifiedNames
+    // need the namespace indices of the server, which are only known at runtime.
+    bool hasStaticInitializer() const;
+    // Scalar initialiser or brace enclosed array initialiser
+    QString cInitializer() const;
+
+    bool operator==(const UAValue& other) const;
+    bool operator!=(const UAValue& other) const { return !(*this == other); }
+
+    friend QDataStream& operator<<(QDataStream& out, const UAValue& value);
+    friend QDataStream& operator>>(QDataStream& in, UAValue& value);
+
+private:
+    union Scalar {
+        qint64 integer;
+        quint64 unsignedInteger;
+        double floatingPoint;
+    };
+
+    Type m_type = Type::Null;
+    bool m_isArray = false;
+    bool m_hasScalar = false;
+    Scalar m_scalar{0};
+    QByteArray m_numbers;
+    QStringList m_strings;
+
+    bool isNumeric() const;
+    bool isUnsigned() const;
+    bool isFloatingPoint() const;
+    int partsPerElement() const;
+    qsizetype elementSize() const;
+    void appendNumber(Scalar number);
+    Scalar number(qsizetype index) const;
+    QString elementInitializer(qsizetype index) const;
+};
+
+#endif // UAVALUE_H